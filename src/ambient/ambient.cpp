@@ -0,0 +1,128 @@
+#include "ambient.h"
+#include <stdio.h>
+#include "constants/constants.h"
+#include "main.h"
+#include "state/state_store.h"
+#include "state/life_model.h"
+#include "helpers/refresh_rate.h"
+#include "helpers/backlight.h"
+#include "power_key/power_key.h"
+#include "log/log.h"
+
+static lv_display_t *ambient_display = nullptr;
+static lv_timer_t *inactivity_timer = nullptr;
+static lv_obj_t *ambient_view = nullptr;
+static volatile bool wake_requested = false;
+
+// Any touch on the view (it covers the whole screen) only wakes the UI
+static void ambient_view_event_cb(lv_event_t *e)
+{
+  ambient_exit();
+}
+
+static void build_ambient_view()
+{
+  ambient_view = lv_obj_create(lv_layer_top());
+  lv_obj_remove_style_all(ambient_view);
+  lv_obj_set_size(ambient_view, SCREEN_WIDTH, SCREEN_HEIGHT);
+  lv_obj_set_style_bg_color(ambient_view, BLACK_COLOR, 0);
+  lv_obj_set_style_bg_opa(ambient_view, LV_OPA_COVER, 0);
+  lv_obj_add_flag(ambient_view, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_add_event_cb(ambient_view, ambient_view_event_cb, LV_EVENT_PRESSED, NULL);
+
+  lv_obj_t *label = lv_label_create(ambient_view);
+  char buf[24];
+  if (life_counter_mode == PLAYER_MODE_TWO_PLAYER)
+  {
+    snprintf(buf, sizeof(buf), "%d   %d", life_model_get(PLAYER_ONE).life_total, life_model_get(PLAYER_TWO).life_total);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_48, 0);
+  }
+  else
+  {
+    snprintf(buf, sizeof(buf), "%d", life_model_get(PLAYER_SINGLE).life_total);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_72, 0);
+  }
+  lv_label_set_text(label, buf);
+  lv_obj_set_style_text_color(label, GRAY_COLOR, 0);
+  lv_obj_center(label);
+}
+
+static uint32_t ambient_timeout_ms()
+{
+  return player_store.getInt(KEY_AMBIENT_TIMEOUT, DEFAULT_AMBIENT_TIMEOUT) * 1000;
+}
+
+// Runs once per timeout; reschedules itself for the remaining time after input
+static void inactivity_timer_cb(lv_timer_t *t)
+{
+  uint32_t timeout_ms = ambient_timeout_ms();
+  if (timeout_ms == 0 || ambient_view)
+  {
+    lv_timer_set_period(t, 1000 * DEFAULT_AMBIENT_TIMEOUT); // look again later, the setting may change
+    return;
+  }
+  uint32_t inactive = lv_display_get_inactive_time(ambient_display);
+  if (inactive < timeout_ms || get_power_state() != POWER_ON)
+  {
+    lv_timer_set_period(t, inactive < timeout_ms ? timeout_ms - inactive : timeout_ms);
+    return;
+  }
+  ambient_enter();
+}
+
+void ambient_init(lv_display_t *display)
+{
+  ambient_display = display;
+  inactivity_timer = lv_timer_create(inactivity_timer_cb, 1000 * DEFAULT_AMBIENT_TIMEOUT, NULL);
+}
+
+void ambient_enter(void)
+{
+  if (ambient_view)
+    return;
+  LOG_I(UI, "[ambient_enter] Dimming after %lums idle\n", (unsigned long)lv_display_get_inactive_time(ambient_display));
+  build_ambient_view();
+  // Drop animations under the view, they would only burn frames nobody sees
+  lv_timer_pause(lv_anim_get_timer());
+  power_enter_ambient();
+  backlight_fade_to(AMBIENT_BRIGHTNESS, BACKLIGHT_AMBIENT_FADE_MS);
+  // Draws the view once, then nothing runs until a wake
+  refresh_rate_freeze(true);
+}
+
+void ambient_exit(void)
+{
+  if (!ambient_view)
+    return;
+  lv_obj_delete_async(ambient_view);
+  ambient_view = nullptr;
+  lv_timer_resume(lv_anim_get_timer());
+  lv_display_trigger_activity(ambient_display);
+  lv_obj_invalidate(lv_screen_active());
+  refresh_rate_freeze(false);
+  backlight_fade_in(BACKLIGHT_WAKE_FADE_MS);
+  power_exit_ambient();
+  uint32_t timeout_ms = ambient_timeout_ms();
+  lv_timer_set_period(inactivity_timer, timeout_ms ? timeout_ms : 1000 * DEFAULT_AMBIENT_TIMEOUT);
+  lv_timer_reset(inactivity_timer);
+  LOG_I(UI, "[ambient_exit] Full UI restored\n");
+}
+
+bool ambient_is_active(void)
+{
+  return ambient_view != nullptr;
+}
+
+void ambient_request_wake(void)
+{
+  wake_requested = true;
+  refresh_rate_notify();
+}
+
+void ambient_poll(void)
+{
+  if (!wake_requested)
+    return;
+  wake_requested = false;
+  ambient_exit();
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <lvgl.h>
+
+// Always-on display: after KEY_AMBIENT_TIMEOUT seconds without input the backlight
+// is dimmed and a static view of the life totals is drawn once. Rendering stays
+// paused and the GUI task waits without a timeout, so the CPU light-sleeps until
+// a touch or the power key brings the full UI back.
+
+void ambient_init(lv_display_t *display);
+void ambient_enter(void);
+void ambient_exit(void);
+bool ambient_is_active(void);
+
+// Safe from other tasks: the exit runs on the GUI task via ambient_poll()
+void ambient_request_wake(void);
+void ambient_poll(void);
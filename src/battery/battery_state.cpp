@@ -1,29 +1,184 @@
 #include "battery_state.h"
+#include "constants/constants.h"
+#include "main.h"
+#include "log/log.h"
 
 float BAT_analogVolts = 0;
 
+// Cached filter output, written by the sampling task only
+static volatile uint16_t battery_mv = 0;
+static volatile uint8_t battery_percent = 0;
+static volatile bool usb_connected = false;
+
+static uint16_t median_window[BATTERY_MEDIAN_WINDOW];
+static uint8_t median_count = 0;
+static uint8_t median_next = 0;
+static uint32_t iir_mv = 0; // scaled by 1 << BATTERY_IIR_SHIFT
+
+// Li-ion open circuit voltage vs. charge, highest voltage first.
+// The top point matches what a full cell reads through the divider.
+struct BatteryCurvePoint
+{
+  uint16_t mv;
+  uint8_t percent;
+};
+
+static const BatteryCurvePoint discharge_curve[] = {
+    {4160, 100},
+    {4060, 90},
+    {3980, 80},
+    {3920, 70},
+    {3870, 60},
+    {3830, 50},
+    {3800, 40},
+    {3770, 30},
+    {3730, 20},
+    {3690, 10},
+    {3600, 5},
+    {3000, 0},
+};
+
+static uint8_t battery_mv_to_percent(uint16_t mv)
+{
+  const int points = sizeof(discharge_curve) / sizeof(discharge_curve[0]);
+  if (mv >= discharge_curve[0].mv)
+    return 100;
+  for (int i = 1; i < points; ++i)
+  {
+    const BatteryCurvePoint &hi = discharge_curve[i - 1];
+    const BatteryCurvePoint &lo = discharge_curve[i];
+    if (mv >= lo.mv)
+      return lo.percent + (uint32_t)(mv - lo.mv) * (hi.percent - lo.percent) / (hi.mv - lo.mv);
+  }
+  return 0;
+}
+
+// Read one averaged burst from the ADC and return the battery voltage in mV
+static bool battery_read_burst(uint16_t *mv)
+{
+  uint32_t sum = 0;
+  for (int i = 0; i < BATTERY_CONVERSIONS; ++i)
+    sum += analogReadMilliVolts(BAT_ADC_PIN);
+  if (sum == 0)
+    return false; // pin not readable, keep the last value
+  // 1:3 divider on the battery line
+  *mv = (uint16_t)(sum / BATTERY_CONVERSIONS * 3 / Measurement_offset);
+  return true;
+}
+
+// Median over the last few bursts drops spikes, the IIR smooths what is left
+static void battery_filter(uint16_t sample_mv)
+{
+  median_window[median_next] = sample_mv;
+  median_next = (median_next + 1) % BATTERY_MEDIAN_WINDOW;
+  if (median_count < BATTERY_MEDIAN_WINDOW)
+    median_count++;
+
+  uint16_t sorted[BATTERY_MEDIAN_WINDOW];
+  memcpy(sorted, median_window, median_count * sizeof(uint16_t));
+  for (int i = 1; i < median_count; ++i)
+  {
+    uint16_t v = sorted[i];
+    int j = i - 1;
+    while (j >= 0 && sorted[j] > v)
+    {
+      sorted[j + 1] = sorted[j];
+      j--;
+    }
+    sorted[j + 1] = v;
+  }
+  uint16_t median = sorted[median_count / 2];
+
+  if (iir_mv == 0)
+    iir_mv = (uint32_t)median << BATTERY_IIR_SHIFT;
+  else
+    iir_mv = iir_mv - (iir_mv >> BATTERY_IIR_SHIFT) + median;
+  uint16_t mv = iir_mv >> BATTERY_IIR_SHIFT;
+  float volts = mv / 1000.0f;
+
+  // Hysteresis: higher to detect USB, lower to confirm disconnect
+  if (!usb_connected && volts > USB_VOLTAGE_THRESHOLD)
+    usb_connected = true;
+  else if (usb_connected && volts < USB_DISCONNECT_THRESHOLD)
+    usb_connected = false;
+
+  battery_mv = mv;
+  battery_percent = battery_mv_to_percent(mv);
+  BAT_analogVolts = volts;
+}
+
+static void battery_task(void *pvParameters)
+{
+  while (true)
+  {
+    vTaskDelay(BATTERY_SAMPLE_PERIOD_MS / portTICK_PERIOD_MS);
+    uint16_t mv;
+    if (battery_read_burst(&mv))
+      battery_filter(mv);
+  }
+}
+
 void battery_init(void)
 {
   // set the resolution to 12 bits (0-4095)
   analogReadResolution(12);
+  analogSetPinAttenuation(BAT_ADC_PIN, ADC_11db);
+
+  // Seed the cache before anyone asks, wake_up() checks for USB right away
+  uint16_t mv;
+  if (battery_read_burst(&mv))
+  {
+    for (int i = 0; i < BATTERY_MEDIAN_WINDOW; ++i)
+      battery_filter(mv);
+  }
+  LOG_I(BATTERY, "[battery_init] %umV, %u%%, USB: %s\n", battery_mv, battery_percent, usb_connected ? "YES" : "NO");
+
+  create_task(battery_task, "battery_task", 3072, NULL, 1);
 }
 
 float battery_get_volts(void)
 {
-  int Volts = analogReadMilliVolts(BAT_ADC_PIN); // millivolts
-  BAT_analogVolts = (float)(Volts * 3.0 / 1000.0) / Measurement_offset;
-  return BAT_analogVolts;
+  return battery_mv / 1000.0f;
 }
 
 float battery_get_percent()
 {
-  float volts = battery_get_volts();
-  float min_voltage = 3.0;
-  float max_voltage = 4.16;
-  float percent = ((volts - min_voltage) / (max_voltage - min_voltage)) * 100.0;
-  if (percent > 100.0)
-    percent = 100.0;
-  if (percent < 0.0)
-    percent = 0.0;
-  return percent;
-}
\ No newline at end of file
+  return battery_percent;
+}
+
+bool battery_is_usb_connected(void)
+{
+  return usb_connected;
+}
+
+// --- GUI side: the cached percentage mirrored into an LVGL subject ---
+
+static lv_subject_t percent_subject;
+static lv_timer_t *subject_timer = nullptr;
+
+static void battery_subject_timer_cb(lv_timer_t *t)
+{
+  battery_subject_update();
+}
+
+void battery_subject_update(void)
+{
+  if (!subject_timer)
+    return;
+  int percent = battery_percent;
+  if (lv_subject_get_int(&percent_subject) != percent)
+    lv_subject_set_int(&percent_subject, percent);
+}
+
+void battery_subject_start(void)
+{
+  if (subject_timer)
+    return;
+  lv_subject_init_int(&percent_subject, battery_percent);
+  subject_timer = lv_timer_create(battery_subject_timer_cb, BATTERY_SUBJECT_PERIOD_MS, NULL);
+}
+
+lv_subject_t *battery_subject_percent(void)
+{
+  return &percent_subject;
+}
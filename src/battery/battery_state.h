@@ -1,11 +1,38 @@
 #pragma once
 #include <Arduino.h>
+#include <lvgl.h>
 
 #define BAT_ADC_PIN 8
 #define Measurement_offset 0.990476
 
+// Background sampling: a low priority task takes a short burst of one-shot ADC
+// reads and filters the result. Getters only read the cached values. One-shot
+// rather than continuous mode, whose driver holds an APB lock while it runs and
+// so would keep the CPU out of light sleep.
+#define BATTERY_SAMPLE_PERIOD_MS 500 // one burst every half second
+#define BATTERY_CONVERSIONS 16       // conversions averaged per burst
+#define BATTERY_MEDIAN_WINDOW 5      // bursts in the median window (odd)
+#define BATTERY_IIR_SHIFT 2          // IIR weight of a new sample: 1 / (1 << shift)
+
+// USB detection voltage threshold
+// USB charging: ~4.16-4.19V, Battery only: ~3.7-4.16V, Threshold: 4.15V
+// Set high enough to reliably detect USB charging vs battery
+// Uses hysteresis: higher to detect USB, lower to confirm disconnect
+#define USB_VOLTAGE_THRESHOLD 4.15f
+#define USB_DISCONNECT_THRESHOLD 4.12f
+
 extern float BAT_analogVolts;
 
 void battery_init(void);
 float battery_get_volts(void);
-float battery_get_percent(void);
\ No newline at end of file
+float battery_get_percent(void);
+bool battery_is_usb_connected(void);
+
+// Int subject with the battery percentage, for views in the GUI task. The
+// sampling task never touches LVGL: an lv_timer copies the cached value over
+// and only notifies when the whole percentage changes.
+#define BATTERY_SUBJECT_PERIOD_MS 5000 // slow on purpose, it keeps the GUI task awake
+void battery_subject_start(void);      // after lv_init, from the GUI task
+lv_subject_t *battery_subject_percent(void);
+// Copy the latest value over now, e.g. when a screen showing it opens
+void battery_subject_update(void);
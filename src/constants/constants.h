@@ -67,12 +67,17 @@ enum ContextualQuadrant
 #define KEY_LIFE_STEP_SMALL "life_step_small"
 #define KEY_LIFE_STEP_LARGE "life_step_large"
 #define KEY_SHOW_TIMER "show_timer"
+#define KEY_AMBIENT_TIMEOUT "ambient_secs"
 
 // define for life increment levels small and large
 #define DEFAULT_LIFE_INCREMENT_SMALL 1
 #define DEFAULT_LIFE_INCREMENT_LARGE 5
 #define DEFAULT_LIFE_MAX 40
 
+// Always-on display: seconds without input before dimming, 0 disables it
+#define DEFAULT_AMBIENT_TIMEOUT 60
+#define AMBIENT_BRIGHTNESS 5
+
 enum step_size_t
 {
   STEP_SIZE_SMALL = 1,
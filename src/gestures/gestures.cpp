@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include "gestures.h"
 #include <constants/constants.h>
+#include <helpers/polar_zones.h>
+#include <touch/touch_capture.h>
 
 // Callback type for gestures
 using GestureCallback = std::function<void()>;
@@ -24,12 +26,41 @@ void register_gesture_callback(GestureType gesture, GestureCallback cb)
 // Call the callback for a gesture
 void trigger_gesture(GestureType gesture)
 {
+#if TOUCH_CAPTURE
+  touch_capture_note_gesture((uint8_t)gesture);
+#endif
   if (gesture_callbacks.count(gesture))
   {
     gesture_callbacks[gesture]();
   }
 }
 
+// Resolve the tap zone with a table lookup, then fire the quadrant gesture followed by its half
+static void trigger_zone_gestures(const lv_point_t &point, GestureType tl, GestureType tr, GestureType bl, GestureType br, GestureType top, GestureType bottom)
+{
+  switch (polar_zone_lookup(&tap_zone_map, point.x, point.y))
+  {
+  case TAP_ZONE_TL:
+    trigger_gesture(tl);
+    trigger_gesture(top);
+    break;
+  case TAP_ZONE_TR:
+    trigger_gesture(tr);
+    trigger_gesture(top);
+    break;
+  case TAP_ZONE_BL:
+    trigger_gesture(bl);
+    trigger_gesture(bottom);
+    break;
+  case TAP_ZONE_BR:
+    trigger_gesture(br);
+    trigger_gesture(bottom);
+    break;
+  default:
+    break;
+  }
+}
+
 // Example LVGL event handler for tap/swipe (to be wired to touch events)
 void lvgl_gesture_event_handler(lv_event_t *e)
 {
@@ -69,6 +100,11 @@ void lvgl_gesture_event_handler(lv_event_t *e)
       trigger_gesture(GestureType::SwipeDown);
       swipe_detected = true;
     }
+    else if (dir == LV_DIR_LEFT || dir == LV_DIR_RIGHT)
+    {
+      trigger_gesture(dir == LV_DIR_LEFT ? GestureType::SwipeLeft : GestureType::SwipeRight);
+      swipe_detected = true;
+    }
   }
   else if (code == LV_EVENT_CLICKED)
   {
@@ -80,118 +116,48 @@ void lvgl_gesture_event_handler(lv_event_t *e)
     }
     if (!swipe_detected)
     {
-      if (point.y < SCREEN_HEIGHT / 2)
-      {
-        if (point.x < SCREEN_WIDTH / 2)
-        {
-          trigger_gesture(GestureType::TapTopLeft);
-        }
-        else
-        {
-          trigger_gesture(GestureType::TapTopRight);
-        }
-        trigger_gesture(GestureType::TapTop);
-      }
-      else
-      {
-        if (point.x < SCREEN_WIDTH / 2)
-        {
-          trigger_gesture(GestureType::TapBottomLeft);
-        }
-        else
-        {
-          trigger_gesture(GestureType::TapBottomRight);
-        }
-        trigger_gesture(GestureType::TapBottom);
-      }
+      trigger_zone_gestures(point, GestureType::TapTopLeft, GestureType::TapTopRight,
+                            GestureType::TapBottomLeft, GestureType::TapBottomRight,
+                            GestureType::TapTop, GestureType::TapBottom);
     }
     // Reset swipe_detected after checking it
     swipe_detected = false;
   }
-  else if (code == LV_EVENT_LONG_PRESSED)
+  else if (code == LV_EVENT_LONG_PRESSED || code == LV_EVENT_LONG_PRESSED_REPEAT)
   {
-    long_press_active = true;
-    // Determine if long press is in top or bottom half
-    if (point.y < SCREEN_HEIGHT / 2)
-    {
-      if (point.x < SCREEN_WIDTH / 2)
-      {
-        trigger_gesture(GestureType::LongPressTopLeft);
-      }
-      else
-      {
-        trigger_gesture(GestureType::LongPressTopRight);
-      }
-      trigger_gesture(GestureType::LongPressTop);
-    }
-    else
-    {
-      if (point.x < SCREEN_WIDTH / 2)
-      {
-        trigger_gesture(GestureType::LongPressBottomLeft);
-      }
-      else
-      {
-        trigger_gesture(GestureType::LongPressBottomRight);
-      }
-      trigger_gesture(GestureType::LongPressBottom);
-    }
-  }
-  else if (code == LV_EVENT_LONG_PRESSED_REPEAT)
-  {
-    // Continue triggering long press actions while held
-    if (point.y < SCREEN_HEIGHT / 2)
-    {
-      if (point.x < SCREEN_WIDTH / 2)
-      {
-        trigger_gesture(GestureType::LongPressTopLeft);
-      }
-      else
-      {
-        trigger_gesture(GestureType::LongPressTopRight);
-      }
-      trigger_gesture(GestureType::LongPressTop);
-    }
-    else
-    {
-      if (point.x < SCREEN_WIDTH / 2)
-      {
-        trigger_gesture(GestureType::LongPressBottomLeft);
-      }
-      else
-      {
-        trigger_gesture(GestureType::LongPressBottomRight);
-      }
-      trigger_gesture(GestureType::LongPressBottom);
-    }
+    // Repeat keeps triggering long press actions while held
+    if (code == LV_EVENT_LONG_PRESSED)
+      long_press_active = true;
+    trigger_zone_gestures(point, GestureType::LongPressTopLeft, GestureType::LongPressTopRight,
+                          GestureType::LongPressBottomLeft, GestureType::LongPressBottomRight,
+                          GestureType::LongPressTop, GestureType::LongPressBottom);
   }
 }
 
 // Example: contextual menu quadrant selection (to be implemented)
 void handle_menu_quadrant(int x, int y)
 {
-  // Assume screen divided into 4 quadrants
-  if (x < LV_HOR_RES / 2 && y < LV_VER_RES / 2)
+  switch (polar_zone_lookup(&tap_zone_map, x, y))
   {
+  case TAP_ZONE_TL:
     trigger_gesture(GestureType::MenuTL); // Top-left
-  }
-  else if (x >= LV_HOR_RES / 2 && y < LV_VER_RES / 2)
-  {
+    break;
+  case TAP_ZONE_TR:
     trigger_gesture(GestureType::MenuTR); // Top-right
-  }
-  else if (x < LV_HOR_RES / 2 && y >= LV_VER_RES / 2)
-  {
+    break;
+  case TAP_ZONE_BL:
     trigger_gesture(GestureType::MenuBL); // Bottom-left
-  }
-  else
-  {
+    break;
+  case TAP_ZONE_BR:
     trigger_gesture(GestureType::MenuBR); // Bottom-right
+    break;
   }
 }
 
 // Initialization function to attach event handler to LVGL objects
 void init_gesture_handling(lv_obj_t *root_obj, lv_indev_t *indev)
 {
+  polar_zones_init(); // Build hit-test tables once, no-op afterwards
   // Only listen to specific events we care about instead of LV_EVENT_ALL for better performance
   lv_obj_add_event_cb(root_obj, lvgl_gesture_event_handler, LV_EVENT_PRESSED, NULL);
   lv_obj_add_event_cb(root_obj, lvgl_gesture_event_handler, LV_EVENT_CLICKED, NULL);
@@ -208,6 +174,17 @@ void clear_gesture_callbacks()
 {
   gesture_callbacks.clear();
 }
+const char *gesture_name(GestureType gesture)
+{
+  static const char *const names[GESTURE_TYPE_COUNT] = {
+      "TapTop", "TapBottom", "TapTopLeft", "TapTopRight", "TapBottomLeft", "TapBottomRight",
+      "SwipeUp", "SwipeDown", "SwipeLeft", "SwipeRight",
+      "LongPressTop", "LongPressBottom", "LongPressTopLeft", "LongPressBottomLeft", "LongPressTopRight", "LongPressBottomRight",
+      "MenuTL", "MenuTR", "MenuBL", "MenuBR"};
+  int index = (int)gesture;
+  return (index >= 0 && index < GESTURE_TYPE_COUNT) ? names[index] : "?";
+}
+
 // Usage example (to be called from your app):
 // register_gesture_callback(GestureType::TapTop, [](){ /* increment counter */ });
 // register_gesture_callback(GestureType::SwipeDown, [](){ /* decrement by 5 */ });
@@ -15,6 +15,8 @@ enum class GestureType
   TapBottomRight,
   SwipeUp,
   SwipeDown,
+  SwipeLeft,
+  SwipeRight,
   LongPressTop,
   LongPressBottom,
   LongPressTopLeft,
@@ -27,9 +29,12 @@ enum class GestureType
   MenuBR
 };
 
+#define GESTURE_TYPE_COUNT ((int)GestureType::MenuBR + 1)
+
 using GestureCallback = std::function<void()>;
 
 void register_gesture_callback(GestureType gesture, GestureCallback cb);
 void init_gesture_handling(lv_obj_t *screen, lv_indev_t *indev);
 void lvgl_gesture_event_handler(lv_event_t *e);
-void clear_gesture_callbacks();
\ No newline at end of file
+void clear_gesture_callbacks();
+const char *gesture_name(GestureType gesture);
\ No newline at end of file
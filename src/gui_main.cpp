@@ -15,6 +15,16 @@
 #include "state/state_store.h"
 #include "timer/timer.h"
 #include "images/logo.h"
+#include "state/game_snapshot.h"
+#include "state/journal.h"
+#include "helpers/backlight.h"
+#include "log/log.h"
+
+#define SPLASH_DELAY_MS 500 // black before the logo comes up
+#define SPLASH_FADE_MS 500
+#define SPLASH_HOLD_MS 1500
+
+static lv_obj_t *splash_logo = nullptr;
 
 void ui_init(lv_indev_t *indev)
 {
@@ -23,7 +33,7 @@ void ui_init(lv_indev_t *indev)
   teardownAllMenus();
 
   // Now load the screen (all objects are hidden/transparent)
-  printf("[lv_create_main_gui] Loading screen\n");
+  LOG_D(UI, "[lv_create_main_gui] Loading screen\n");
   lv_scr_load(lv_obj_create(NULL));
   init_gesture_handling(lv_scr_act(), indev);
   lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), LV_PART_MAIN);
@@ -31,28 +41,103 @@ void ui_init(lv_indev_t *indev)
   // Disable scrollbars on screen
   lv_obj_clear_flag(lv_scr_act(), LV_OBJ_FLAG_SCROLLABLE);
 
-  // Create logo image (360x358 native resolution)
-  lv_obj_t *logo_img = lv_img_create(lv_scr_act());
-  lv_img_set_src(logo_img, &logo);
-  lv_obj_align(logo_img, LV_ALIGN_CENTER, 0, 0);
-
-  // Start fade-in for logo image (fade_in_obj handles initial transparency)
-  fade_in_obj(logo_img, 500, 500, [](lv_anim_t *a)
-              {
-    // Fade out title label, then show life counter
-    if (a && a->var) {
-      fade_out_obj((lv_obj_t *)a->var, 500, 1500, [](lv_anim_t *anim) {
-        if (anim && anim->var) {
-          lv_obj_add_flag((lv_obj_t *)anim->var, LV_OBJ_FLAG_HIDDEN);
-        }
-        PlayerMode player_mode = (PlayerMode)player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER);
-        // Now show the life counter (arc, label, animation)
-        life_counter_mode = player_mode;
-        if (player_mode == PLAYER_MODE_ONE_PLAYER) {
-          init_life_counter();
-        } else {
-          init_life_counter_2P();
-        }
-      });
-    } });
+  // Back from deep sleep with a game in RTC memory, or from a crash with one in the
+  // journal: show it as it was, no splash or sweep
+  if (game_snapshot_restore() || journal_replay())
+  {
+    if (life_counter_mode == PLAYER_MODE_ONE_PLAYER)
+    {
+      prebuild_life_counter_2P();
+      resume_life_counter();
+    }
+    else
+    {
+      prebuild_life_counter();
+      resume_life_counter_2P();
+    }
+    return;
+  }
+
+  // Create logo image (360x358 native resolution). It stays opaque: the splash
+  // fades the backlight instead, so no frame is redrawn during the fades.
+  splash_logo = lv_img_create(lv_scr_act());
+  lv_img_set_src(splash_logo, &logo);
+  lv_obj_align(splash_logo, LV_ALIGN_CENTER, 0, 0);
+}
+
+// Splash timeline, one step per timer shot
+enum SplashStep
+{
+  SPLASH_FADE_IN,
+  SPLASH_FADE_OUT,
+  SPLASH_DONE
+};
+static SplashStep splash_step;
+
+static void splash_timer_cb(lv_timer_t *timer)
+{
+  switch (splash_step)
+  {
+  case SPLASH_FADE_IN:
+    backlight_fade_in(SPLASH_FADE_MS);
+    lv_timer_set_period(timer, SPLASH_FADE_MS + SPLASH_HOLD_MS);
+    splash_step = SPLASH_FADE_OUT;
+    break;
+  case SPLASH_FADE_OUT:
+    backlight_fade_out(SPLASH_FADE_MS);
+    lv_timer_set_period(timer, SPLASH_FADE_MS);
+    splash_step = SPLASH_DONE;
+    break;
+  case SPLASH_DONE:
+  {
+    lv_timer_delete(timer);
+    lv_obj_delete(splash_logo);
+    splash_logo = nullptr;
+    PlayerMode player_mode = (PlayerMode)player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER);
+    // Now show the life counter (arc, label, animation)
+    life_counter_mode = player_mode;
+    if (player_mode == PLAYER_MODE_ONE_PLAYER)
+    {
+      init_life_counter();
+      prebuild_life_counter_2P();
+    }
+    else
+    {
+      init_life_counter_2P();
+      prebuild_life_counter();
+    }
+    backlight_fade_in(BACKLIGHT_FADE_MS);
+    break;
+  }
+  }
+}
+
+void ui_reveal(void)
+{
+  if (!splash_logo)
+  {
+    backlight_fade_in(BACKLIGHT_FADE_MS);
+    return;
+  }
+  splash_step = SPLASH_FADE_IN;
+  lv_timer_create(splash_timer_cb, SPLASH_DELAY_MS, NULL);
+}
+
+// Hot player mode switch: keeps the screen and gesture wiring, swaps the prebuilt
+// views and leaves each mode's life totals, history and timer untouched
+void switch_player_mode(PlayerMode mode)
+{
+  uint32_t start_us = micros();
+  if (mode == PLAYER_MODE_ONE_PLAYER)
+  {
+    suspend_life_counter_2P();
+    resume_life_counter();
+  }
+  else
+  {
+    suspend_life_counter();
+    resume_life_counter_2P();
+  }
+  life_counter_mode = mode;
+  LOG_D(UI, "[switch_player_mode] Switched to mode %d in %u us\n", mode, (unsigned)(micros() - start_us));
 }
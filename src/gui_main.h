@@ -2,12 +2,17 @@
 #define GUI_MAIN_H
 
 #include <lvgl.h>
+#include "constants/constants.h"
 
 // Global input device reference
 extern lv_indev_t *global_indev;
 
 // Function to create the main GUI
 void ui_init(lv_indev_t *indev);
+// Called once the first frame is on the panel: brings the backlight up, or
+// runs the boot splash when there was no game to resume
+void ui_reveal(void);
 lv_indev_t* init_touch(void);
+void switch_player_mode(PlayerMode mode);
 
 #endif // GUI_MAIN_H
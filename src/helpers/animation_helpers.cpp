@@ -8,69 +8,131 @@ void text_fade_anim_cb(void *label_obj, int32_t opa)
   lv_obj_set_style_text_opa((lv_obj_t *)label_obj, opa, 0);
 }
 
-// Called when the fade-in animation finishes
-// Helper: fade in a label or arc
-void fade_in_obj(lv_obj_t *obj, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb)
+// One named exec callback per property so the (object, exec_cb) pair is a stable key
+static void arc_fade_anim_cb(void *arc_obj, int32_t opa)
 {
-  lv_anim_t anim;
-  lv_anim_init(&anim);
-  lv_anim_set_var(&anim, obj);
-  if (lv_obj_check_type(obj, &lv_label_class))
+  lv_obj_set_style_arc_opa((lv_obj_t *)arc_obj, opa, LV_PART_INDICATOR);
+}
+
+static void obj_fade_anim_cb(void *obj, int32_t opa)
+{
+  lv_obj_set_style_opa((lv_obj_t *)obj, opa, LV_PART_MAIN);
+}
+
+static void x_anim_cb(void *obj, int32_t x)
+{
+  lv_obj_set_x((lv_obj_t *)obj, x);
+}
+
+static void y_anim_cb(void *obj, int32_t y)
+{
+  lv_obj_set_y((lv_obj_t *)obj, y);
+}
+
+static lv_anim_exec_xcb_t exec_cb_for(AnimProperty prop)
+{
+  switch (prop)
   {
-    lv_anim_set_exec_cb(&anim, text_fade_anim_cb);
-    lv_obj_set_style_text_opa(obj, LV_OPA_TRANSP, 0);
+  case ANIM_PROP_TEXT_OPA:
+    return text_fade_anim_cb;
+  case ANIM_PROP_ARC_OPA:
+    return arc_fade_anim_cb;
+  case ANIM_PROP_X:
+    return x_anim_cb;
+  case ANIM_PROP_Y:
+    return y_anim_cb;
+  case ANIM_PROP_OPA:
+  default:
+    return obj_fade_anim_cb;
   }
-  else if (lv_obj_check_type(obj, &lv_arc_class))
+}
+
+static void apply_opa(lv_obj_t *obj, AnimProperty prop, lv_opa_t opa)
+{
+  if (prop == ANIM_PROP_TEXT_OPA)
+    lv_obj_set_style_text_opa(obj, opa, 0);
+  else if (prop == ANIM_PROP_ARC_OPA)
+    lv_obj_set_style_arc_opa(obj, opa, LV_PART_INDICATOR);
+  else
+    lv_obj_set_style_opa(obj, opa, LV_PART_MAIN);
+}
+
+// Which opacity property fades a given widget; hot paths pass the property directly instead
+AnimProperty anim_opa_property_for(lv_obj_t *obj)
+{
+  const lv_obj_class_t *cls = lv_obj_get_class(obj);
+  if (cls == &lv_label_class)
+    return ANIM_PROP_TEXT_OPA;
+  if (cls == &lv_arc_class)
+    return ANIM_PROP_ARC_OPA;
+  return ANIM_PROP_OPA;
+}
+
+// Start an animation keyed by (var, exec_cb). A running animation with the same key
+// is either replaced or extended in place, so repeated triggers never stack up.
+lv_anim_t *anim_start_keyed(const lv_anim_t *anim, AnimRetrigger mode)
+{
+  lv_anim_t *running = lv_anim_get(anim->var, anim->exec_cb);
+  if (running && mode == ANIM_EXTEND)
   {
-    lv_anim_set_exec_cb(&anim, [](void *arc_obj, int32_t opa)
-                        { lv_obj_set_style_arc_opa((lv_obj_t *)arc_obj, opa, LV_PART_INDICATOR); });
-    lv_obj_set_style_arc_opa(obj, LV_OPA_TRANSP, LV_PART_INDICATOR);
+    running->start_value = anim->start_value;
+    running->current_value = anim->start_value;
+    running->end_value = anim->end_value;
+    running->duration = anim->duration;
+    running->act_time = anim->act_time; // restarts the delay countdown
+    running->completed_cb = anim->completed_cb;
+    return running;
   }
-  else
+  if (running)
+    lv_anim_delete(anim->var, anim->exec_cb);
+  return lv_anim_start(anim);
+}
+
+// Cancel every animation on an object and its children (e.g. before hiding or deleting it)
+void anim_cancel(lv_obj_t *obj)
+{
+  if (!obj)
+    return;
+  lv_anim_delete(obj, NULL);
+  uint32_t child_cnt = lv_obj_get_child_count(obj);
+  for (uint32_t i = 0; i < child_cnt; i++)
   {
-    // For buttons and general objects, animate LV_STYLE_OPA on LV_PART_MAIN
-    lv_anim_set_exec_cb(&anim, [](void *o, int32_t opa)
-                        { lv_obj_set_style_opa((lv_obj_t *)o, opa, LV_PART_MAIN); });
-    lv_obj_set_style_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN);
+    anim_cancel(lv_obj_get_child(obj, i));
   }
-  lv_anim_set_values(&anim, LV_OPA_TRANSP, LV_OPA_COVER);
-  lv_anim_set_time(&anim, duration);
-  lv_anim_set_delay(&anim, delay);
-  if (ready_cb)
-    lv_anim_set_ready_cb(&anim, ready_cb);
-  lv_anim_start(&anim);
 }
 
-// Helper: fade out a label or arc
-void fade_out_obj(lv_obj_t *obj, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb)
+uint32_t anim_live_count()
+{
+  return lv_anim_count_running();
+}
+
+// Helper: fade a single opacity property between two values
+void fade_obj(lv_obj_t *obj, AnimProperty prop, lv_opa_t from, lv_opa_t to, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb, AnimRetrigger mode)
 {
   lv_anim_t anim;
   lv_anim_init(&anim);
   lv_anim_set_var(&anim, obj);
-  if (lv_obj_check_type(obj, &lv_label_class))
-  {
-    lv_anim_set_exec_cb(&anim, text_fade_anim_cb);
-    lv_obj_set_style_text_opa(obj, LV_OPA_COVER, 0);
-  }
-  else if (lv_obj_check_type(obj, &lv_arc_class))
-  {
-    lv_anim_set_exec_cb(&anim, [](void *arc_obj, int32_t opa)
-                        { lv_obj_set_style_arc_opa((lv_obj_t *)arc_obj, opa, LV_PART_INDICATOR); });
-    lv_obj_set_style_arc_opa(obj, LV_OPA_COVER, LV_PART_INDICATOR);
-  }
-  else
-  {
-    // For buttons and general objects, animate LV_STYLE_OPA on LV_PART_MAIN
-    lv_anim_set_exec_cb(&anim, [](void *o, int32_t opa)
-                        { lv_obj_set_style_opa((lv_obj_t *)o, opa, LV_PART_MAIN); });
-    lv_obj_set_style_opa(obj, LV_OPA_COVER, LV_PART_MAIN);
-  }
-  lv_anim_set_values(&anim, LV_OPA_COVER, LV_OPA_TRANSP);
+  lv_anim_set_exec_cb(&anim, exec_cb_for(prop));
+  apply_opa(obj, prop, from);
+  lv_anim_set_values(&anim, from, to);
   lv_anim_set_time(&anim, duration);
   lv_anim_set_delay(&anim, delay);
   if (ready_cb)
     lv_anim_set_ready_cb(&anim, ready_cb);
-  lv_anim_start(&anim);
+  anim_start_keyed(&anim, mode);
+}
+
+// Called when the fade-in animation finishes
+// Helper: fade in a label or arc
+void fade_in_obj(lv_obj_t *obj, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb)
+{
+  fade_obj(obj, anim_opa_property_for(obj), LV_OPA_TRANSP, LV_OPA_COVER, duration, delay, ready_cb);
+}
+
+// Helper: fade out a label or arc
+void fade_out_obj(lv_obj_t *obj, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb)
+{
+  fade_obj(obj, anim_opa_property_for(obj), LV_OPA_COVER, LV_OPA_TRANSP, duration, delay, ready_cb);
 }
 
 // slide in animation for menus or side panels
@@ -79,15 +141,14 @@ void slide_in_obj_horizontal(lv_obj_t *obj, lv_coord_t start_x, lv_coord_t end_x
   lv_anim_t anim;
   lv_anim_init(&anim);
   lv_anim_set_var(&anim, obj);
-  lv_anim_set_exec_cb(&anim, [](void *o, int32_t x)
-                      { lv_obj_set_x((lv_obj_t *)o, x); });
+  lv_anim_set_exec_cb(&anim, x_anim_cb);
   lv_obj_set_x(obj, start_x); // Start position
   lv_anim_set_values(&anim, start_x, end_x);
   lv_anim_set_time(&anim, duration);
   lv_anim_set_delay(&anim, delay);
   if (ready_cb)
     lv_anim_set_ready_cb(&anim, ready_cb);
-  lv_anim_start(&anim);
+  anim_start_keyed(&anim);
 }
 
 // slide in animation for vertical movement (Y axis)
@@ -96,13 +157,12 @@ void slide_in_obj_vertical(lv_obj_t *obj, lv_coord_t start_y, lv_coord_t end_y,
   lv_anim_t anim;
   lv_anim_init(&anim);
   lv_anim_set_var(&anim, obj);
-  lv_anim_set_exec_cb(&anim, [](void *o, int32_t y)
-                      { lv_obj_set_y((lv_obj_t *)o, y); });
+  lv_anim_set_exec_cb(&anim, y_anim_cb);
   lv_obj_set_y(obj, start_y); // Start position
   lv_anim_set_values(&anim, start_y, end_y);
   lv_anim_set_time(&anim, duration);
   lv_anim_set_delay(&anim, delay);
   if (ready_cb)
     lv_anim_set_ready_cb(&anim, ready_cb);
-  lv_anim_start(&anim);
-}
\ No newline at end of file
+  anim_start_keyed(&anim);
+}
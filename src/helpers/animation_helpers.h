@@ -1,7 +1,30 @@
 #include <stdio.h>
 #include <lvgl.h>
 
+// Animated style property. Together with the object it forms the key of an
+// animation, so at most one animation per (object, property) is ever running.
+enum AnimProperty
+{
+  ANIM_PROP_OPA,      // LV_STYLE_OPA on LV_PART_MAIN (buttons, images, containers)
+  ANIM_PROP_TEXT_OPA, // labels
+  ANIM_PROP_ARC_OPA,  // arc indicator
+  ANIM_PROP_X,
+  ANIM_PROP_Y
+};
+
+// What to do when an animation with the same key is already running
+enum AnimRetrigger
+{
+  ANIM_RESTART, // cancel the running one and start fresh
+  ANIM_EXTEND   // keep the running one and restart its delay/timing in place
+};
+
 void text_fade_anim_cb(void *label_obj, int32_t opa);
+AnimProperty anim_opa_property_for(lv_obj_t *obj);
+lv_anim_t *anim_start_keyed(const lv_anim_t *anim, AnimRetrigger mode = ANIM_RESTART);
+void anim_cancel(lv_obj_t *obj);
+uint32_t anim_live_count();
+void fade_obj(lv_obj_t *obj, AnimProperty prop, lv_opa_t from, lv_opa_t to, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb = NULL, AnimRetrigger mode = ANIM_RESTART);
 void fade_in_obj(lv_obj_t *obj, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb = NULL);
 void fade_out_obj(lv_obj_t *obj, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb = NULL);
 void slide_in_obj_horizontal(lv_obj_t *obj, lv_coord_t start_x, lv_coord_t end_x, uint32_t duration, uint32_t delay, lv_anim_ready_cb_t ready_cb = NULL);
@@ -0,0 +1,125 @@
+#include "arc_update.h"
+#include <stdio.h>
+
+static ArcUpdateStats stats = {};
+
+// Angle in [0, 360), as lv_arc keeps them
+static int32_t norm_angle(int32_t a)
+{
+  a %= 360;
+  return a < 0 ? a + 360 : a;
+}
+
+// Clockwise span from start to end, 360 for a full ring
+static int32_t arc_span(int32_t start, int32_t end)
+{
+  int32_t span = end - start;
+  if (span < 0)
+    span += 360;
+  return span;
+}
+
+// Same geometry as lv_arc's indicator: centered in the main part's content
+// box, inset by the indicator padding
+static void indicator_geometry(lv_obj_t *arc, lv_point_t *center, int32_t *radius)
+{
+  lv_area_t coords;
+  lv_obj_get_coords(arc, &coords);
+  int32_t left = lv_obj_get_style_pad_left(arc, LV_PART_MAIN);
+  int32_t right = lv_obj_get_style_pad_right(arc, LV_PART_MAIN);
+  int32_t top = lv_obj_get_style_pad_top(arc, LV_PART_MAIN);
+  int32_t bottom = lv_obj_get_style_pad_bottom(arc, LV_PART_MAIN);
+  int32_t r = LV_MIN(lv_area_get_width(&coords) - left - right, lv_area_get_height(&coords) - top - bottom) / 2;
+  center->x = coords.x1 + r + left;
+  center->y = coords.y1 + r + top;
+  int32_t indic_pad = LV_MAX(lv_obj_get_style_pad_left(arc, LV_PART_INDICATOR), lv_obj_get_style_pad_top(arc, LV_PART_INDICATOR));
+  *radius = r - indic_pad;
+}
+
+// Invalidate the ring between two angles (clockwise from start to end) and
+// return the pixel count
+static uint32_t invalidate_sector(lv_obj_t *arc, int32_t start, int32_t end)
+{
+  if (start == end)
+    return 0;
+  lv_point_t center;
+  int32_t radius;
+  indicator_geometry(arc, &center, &radius);
+  int32_t width = lv_obj_get_style_arc_width(arc, LV_PART_INDICATOR);
+  bool rounded = lv_obj_get_style_arc_rounded(arc, LV_PART_INDICATOR);
+  lv_area_t area;
+  lv_draw_arc_get_area(center.x, center.y, radius, start, end, width, rounded, &area);
+  lv_area_increase(&area, 1, 1); // anti-aliased edge
+
+  lv_area_t coords;
+  lv_obj_get_coords(arc, &coords);
+  if (!lv_area_intersect(&area, &area, &coords))
+    return 0;
+  lv_obj_invalidate_area(arc, &area);
+  return lv_area_get_size(&area);
+}
+
+// Slice swept by one end of the arc moving from one angle to another, whichever
+// way round is shorter
+static uint32_t invalidate_moved_edge(lv_obj_t *arc, int32_t from, int32_t to)
+{
+  if (norm_angle(to - from) < 180)
+    return invalidate_sector(arc, norm_angle(from), norm_angle(to));
+  return invalidate_sector(arc, norm_angle(to), norm_angle(from));
+}
+
+void arc_update(lv_obj_t *arc, const arc_segment_t &seg)
+{
+  int32_t old_start = (int32_t)lv_arc_get_angle_start(arc);
+  int32_t old_end = (int32_t)lv_arc_get_angle_end(arc);
+  bool recolor = !lv_color_eq(lv_obj_get_style_arc_color(arc, LV_PART_INDICATOR), seg.color);
+
+  // Let lv_arc update its state without invalidating anything itself
+  lv_display_t *disp = lv_obj_get_display(arc);
+  lv_display_enable_invalidation(disp, false);
+  lv_arc_set_angles(arc, seg.start_angle, seg.end_angle);
+  if (recolor)
+    lv_obj_set_style_arc_color(arc, seg.color, LV_PART_INDICATOR);
+  lv_display_enable_invalidation(disp, true);
+
+  int32_t new_start = (int32_t)lv_arc_get_angle_start(arc);
+  int32_t new_end = (int32_t)lv_arc_get_angle_end(arc);
+  int32_t old_span = arc_span(old_start, old_end);
+  int32_t new_span = arc_span(new_start, new_end);
+
+  uint32_t px = 0;
+  if (!lv_obj_is_visible(arc))
+  {
+    // Hidden or in a suspended view: showing it redraws it anyway
+  }
+  else if (recolor || LV_ABS(new_span - old_span) > 180)
+  {
+    // Whole ring in the new color, plus whatever the old arc covered outside it
+    px += invalidate_sector(arc, norm_angle(new_start), norm_angle(new_end));
+    if (old_span > 0 && (old_start != new_start || old_end != new_end))
+      px += invalidate_sector(arc, norm_angle(old_start), norm_angle(old_end));
+    stats.ring_redraws++;
+  }
+  else
+  {
+    // Only the slices that appeared or disappeared at either end
+    px += invalidate_moved_edge(arc, old_end, new_end);
+    px += invalidate_moved_edge(arc, old_start, new_start);
+  }
+
+  stats.updates++;
+  stats.last_px = px;
+  stats.total_px += px;
+  if (px > stats.max_px)
+    stats.max_px = px;
+}
+
+const ArcUpdateStats &arc_update_stats(void)
+{
+  return stats;
+}
+
+void arc_update_stats_reset(void)
+{
+  stats = {};
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <lvgl.h>
+#include "constants/constants.h"
+
+// Life arc updates with minimal invalidation. lv_arc redraws its whole box on
+// every indicator color set and on large angle jumps, which on a full-diameter
+// arc is the whole screen. Here only the angular sectors between the old and new
+// start/end angles are invalidated, and the whole ring only when the color
+// actually changes.
+
+struct ArcUpdateStats
+{
+  uint32_t updates;
+  uint32_t ring_redraws; // updates that changed the color
+  uint32_t last_px;      // pixels invalidated by the last update
+  uint32_t max_px;
+  uint64_t total_px;
+};
+
+void arc_update(lv_obj_t *arc, const arc_segment_t &seg);
+const ArcUpdateStats &arc_update_stats(void);
+void arc_update_stats_reset(void);
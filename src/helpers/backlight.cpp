@@ -0,0 +1,137 @@
+#include "backlight.h"
+#include <stdio.h>
+#include <driver/ledc.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <esp_display_panel.hpp>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "constants/constants.h"
+#include "state/state_store.h"
+#include "power_key/power_pm.h"
+#include "log/log.h"
+
+extern esp_panel::board::Board *board;
+
+static bool fader_ready = false;
+static int current_level = 0;
+// Levels and fades come from the GUI task and from power callbacks alike, and
+// current_level and the LEDC fade state must change together
+static SemaphoreHandle_t backlight_mutex = nullptr;
+
+// The panel library clocks the timer from APB, which stops in light sleep and
+// would blank the screen. Same timer, frequency and resolution, RC_FAST clock.
+static esp_err_t backlight_use_sleep_clock(void)
+{
+  ledc_timer_config_t timer_cfg = {};
+  timer_cfg.speed_mode = BACKLIGHT_LEDC_MODE;
+  timer_cfg.duty_resolution = (ledc_timer_bit_t)BACKLIGHT_DUTY_BITS;
+  timer_cfg.timer_num = BACKLIGHT_LEDC_TIMER;
+  timer_cfg.freq_hz = ESP_PANEL_BOARD_BACKLIGHT_PWM_FREQ_HZ;
+  timer_cfg.clk_cfg = LEDC_USE_RC_FAST_CLK;
+  esp_err_t err = ledc_timer_config(&timer_cfg);
+  if (err != ESP_OK)
+    return err;
+  // Keep the oscillator and the pad's normal function through light sleep
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RC_FAST, ESP_PD_OPTION_ON);
+  gpio_sleep_sel_dis((gpio_num_t)ESP_PANEL_BOARD_BACKLIGHT_IO);
+  return ESP_OK;
+}
+
+void backlight_init(void)
+{
+  backlight_mutex = xSemaphoreCreateMutex();
+  esp_err_t err = ledc_fade_func_install(0);
+  // Already installed by someone else is fine too
+  fader_ready = (err == ESP_OK || err == ESP_ERR_INVALID_STATE);
+  if (!fader_ready)
+    LOG_W(DISPLAY, "[backlight_init] No hardware fades: %s\n", esp_err_to_name(err));
+
+  err = backlight_use_sleep_clock();
+  if (err != ESP_OK)
+  {
+    // Still on APB: a light sleep would blank the screen, so never take one
+    LOG_W(DISPLAY, "[backlight_init] PWM stays on APB (%s), light sleep off\n", esp_err_to_name(err));
+    pm_lock(PM_LOCK_BACKLIGHT);
+  }
+}
+
+static uint32_t duty_for(int percent)
+{
+  if (percent < 0)
+    percent = 0;
+  if (percent > 100)
+    percent = 100;
+  return (uint32_t)percent * ((1u << BACKLIGHT_DUTY_BITS) - 1) / 100;
+}
+
+static void backlight_lock(void)
+{
+  if (backlight_mutex)
+    xSemaphoreTake(backlight_mutex, portMAX_DELAY);
+}
+
+static void backlight_unlock(void)
+{
+  if (backlight_mutex)
+    xSemaphoreGive(backlight_mutex);
+}
+
+// Callers hold the mutex
+static void set_level_locked(int percent)
+{
+  if (fader_ready)
+    ledc_fade_stop(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL);
+  if (board && board->getBacklight())
+    board->getBacklight()->setBrightness(percent);
+  current_level = percent;
+}
+
+void backlight_set_level(int percent)
+{
+  backlight_lock();
+  set_level_locked(percent);
+  backlight_unlock();
+}
+
+void backlight_fade_to(int percent, uint32_t duration_ms, bool wait)
+{
+  backlight_lock();
+  if (!fader_ready || duration_ms == 0 || percent == current_level)
+  {
+    set_level_locked(percent);
+    backlight_unlock();
+    return;
+  }
+  ledc_fade_stop(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL);
+  esp_err_t err = ledc_set_fade_with_time(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL, duty_for(percent), duration_ms);
+  if (err == ESP_OK)
+    err = ledc_fade_start(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+  if (err != ESP_OK)
+  {
+    LOG_W(DISPLAY, "[backlight_fade_to] Fade failed (%s), setting %d%% directly\n", esp_err_to_name(err), percent);
+    set_level_locked(percent);
+    backlight_unlock();
+    return;
+  }
+  current_level = percent;
+  backlight_unlock();
+  // Wait outside the mutex, so a wake from another task can still cut the fade short
+  if (wait)
+    vTaskDelay(pdMS_TO_TICKS(duration_ms) + 1);
+}
+
+int backlight_user_level(void)
+{
+  return player_store.getInt(KEY_BRIGHTNESS, 100);
+}
+
+void backlight_fade_in(uint32_t duration_ms)
+{
+  backlight_fade_to(backlight_user_level(), duration_ms);
+}
+
+void backlight_fade_out(uint32_t duration_ms, bool wait)
+{
+  backlight_fade_to(0, duration_ms, wait);
+}
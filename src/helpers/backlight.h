@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+// Backlight levels and fades on the LEDC hardware fader behind
+// board->getBacklight(). A whole-panel fade to or from black costs no rendering
+// and no panel bus traffic: the CPU only programs the target and duration.
+// Brightness is in percent, like KEY_BRIGHTNESS.
+//
+// The PWM timer is moved to the RC_FAST clock, which keeps running in light
+// sleep, so the CPU can sleep between frames with the screen lit.
+
+#define BACKLIGHT_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_LEDC_CHANNEL LEDC_CHANNEL_0 // ESP32_Display_Panel's PWM_LEDC default
+#define BACKLIGHT_LEDC_TIMER LEDC_TIMER_0     // same
+#define BACKLIGHT_DUTY_BITS 10                // ESP_PANEL_BOARD_BACKLIGHT_PWM_DUTY_RESOLUTION
+
+#define BACKLIGHT_FADE_MS 300        // first reveal, and into the game after the splash
+#define BACKLIGHT_WAKE_FADE_MS 120   // short so a wake still feels instant
+#define BACKLIGHT_SLEEP_FADE_MS 250
+#define BACKLIGHT_AMBIENT_FADE_MS 800
+
+void backlight_init(void);
+// Instant, cancels a running fade
+void backlight_set_level(int percent);
+// wait blocks the caller until the fade is done
+void backlight_fade_to(int percent, uint32_t duration_ms, bool wait = false);
+// To and from the user's KEY_BRIGHTNESS
+void backlight_fade_in(uint32_t duration_ms);
+void backlight_fade_out(uint32_t duration_ms, bool wait = false);
+int backlight_user_level(void);
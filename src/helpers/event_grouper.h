@@ -4,15 +4,8 @@
 #include <functional>
 #include <Arduino.h>
 #include <timer/timer.h>
-
-struct LifeHistoryEvent
-{
-  int net_life_change;
-  int life_total;
-  int player_id;        // 0 for single, 1/2 for 2P
-  uint32_t timestamp;   // Time since boot
-  int change_timestamp; // seconds since game started
-};
+#include "helpers/history_log.h"
+#include "helpers/game_clock.h"
 
 class EventGrouper
 {
@@ -25,8 +18,10 @@ public:
         last_event_time(0),
         life_total(initial_life),
         group_start_time(0),
+        started_timer(false),
         commit_callback(nullptr),
-        change_timestamp(0)
+        change_timestamp(0),
+        history(player_id)
   {
   }
 
@@ -53,9 +48,11 @@ public:
     if (!get_is_timer_running())
     {
       toggle_timer_running(); // Ensure timer is running
+      started_timer = true;
     }
     commit_callback = onCommit;
-    uint32_t now = millis();
+    redo_stack.clear(); // a new change forks the history
+    uint32_t now = game_clock_millis();
     last_event_time = now;
     net_change += change;
     change_timestamp = game_timestamp;
@@ -70,36 +67,120 @@ public:
   // Call this periodically (e.g., in loop) to check for timeout
   void loop()
   {
-    uint32_t now = millis(); // MS since boot
+    uint32_t now = game_clock_millis(); // MS since boot
     bool isWindowExpired = (now - last_event_time) > grouping_window;
-    if (active && isWindowExpired && net_change != 0)
+    if (isWindowExpired)
+      commitNow();
+  }
+
+  // Commit the pending group without waiting for the window (e.g. before deep sleep)
+  void commitNow()
+  {
+    if (active && net_change != 0)
     {
       int new_life_total = life_total + net_change;
-      LifeHistoryEvent evt{net_change, new_life_total, player_id, last_event_time, change_timestamp};
-      history.push_back(evt);
+      LifeHistoryEvent evt{net_change, new_life_total, player_id, last_event_time + timestamp_offset, change_timestamp};
+      history.append(evt);
       life_total = new_life_total; // Update state to latest committed value
       if (commit_callback)
         commit_callback(evt);
       // Clear commit pending state immediately after callback
       active = false;
       net_change = 0;
+      started_timer = false;
       commit_callback = nullptr; // Clear callback to avoid dangling reference
     }
   }
 
-  // Access history
-  std::vector<LifeHistoryEvent> getHistory()
+  // Reverts the pending group if there is one, else the newest committed event.
+  // Constant time: the history is trimmed in place, nothing is copied.
+  bool undo()
+  {
+    if (active)
+    {
+      // Not committed yet, so there is nothing to redo. Drop everything the
+      // group set up, including the stopwatch if its first tap started it.
+      if (started_timer && get_is_timer_running())
+        toggle_timer_running();
+      active = false;
+      net_change = 0;
+      group_start_time = 0;
+      started_timer = false;
+      commit_callback = nullptr;
+      return true;
+    }
+    LifeHistoryEvent evt;
+    if (!history.removeLast(evt))
+      return false;
+    life_total -= evt.net_life_change;
+    redo_stack.push_back(evt);
+    return true;
+  }
+
+  // Re-applies the newest undone event, until a new change is made
+  bool redo(LifeHistoryEvent *redone = nullptr)
+  {
+    if (active || redo_stack.empty())
+      return false;
+    LifeHistoryEvent evt = redo_stack.back();
+    redo_stack.pop_back();
+    history.append(evt);
+    life_total = evt.life_total;
+    if (redone)
+      *redone = evt;
+    return true;
+  }
+
+  size_t getUndoDepth() const
+  {
+    return history.size() + (active ? 1 : 0);
+  }
+
+  size_t getRedoDepth() const
+  {
+    return redo_stack.size();
+  }
+
+  // Drop the journal hook of a pending group, e.g. on a copy of the grouper
+  void clearCommitCallback()
+  {
+    commit_callback = nullptr;
+  }
+
+  // Compact history, walk it with getHistoryLog().cursor()
+  const HistoryLog &getHistoryLog() const
   {
     return history;
   }
 
+  // Decoded copy of the whole history
+  std::vector<LifeHistoryEvent> getHistory() const
+  {
+    return history.toVector();
+  }
+
+  // Replace the state with a saved history (e.g. from the RTC snapshot)
+  void restoreHistory(int restored_life_total, const std::vector<LifeHistoryEvent> &events)
+  {
+    resetHistory(restored_life_total);
+    // Keep new events ordered after the restored ones, they came from a previous boot
+    for (const LifeHistoryEvent &evt : events)
+    {
+      history.append(evt);
+      if (evt.timestamp >= timestamp_offset)
+        timestamp_offset = evt.timestamp + 1;
+    }
+  }
+
   // Helper: Reset history
   void resetHistory(int base_life)
   {
     history.clear();
+    redo_stack.clear();
     active = false;
     net_change = 0;
     group_start_time = 0;
+    started_timer = false;
     last_event_time = 0;
     change_timestamp = 0;
     life_total = base_life;
@@ -112,8 +193,12 @@ private:
   int player_id;
   int life_total;
   uint32_t group_start_time;
+  bool started_timer; // the pending group's first change started the stopwatch
   uint32_t last_event_time;
   int change_timestamp;
-  std::vector<LifeHistoryEvent> history;
+  HistoryLog history;
+  std::vector<LifeHistoryEvent> redo_stack;
   std::function<void(const LifeHistoryEvent &)> commit_callback;
+  // Added to event timestamps, shared so 2P histories still merge in order
+  inline static uint32_t timestamp_offset = 0;
 };
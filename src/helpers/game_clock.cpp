@@ -0,0 +1,27 @@
+#include "game_clock.h"
+#include <Arduino.h>
+#include "timer/timer.h"
+
+static clock_ms_cb_t override_ms = nullptr;
+static clock_seconds_cb_t override_seconds = nullptr;
+
+void game_clock_override(clock_ms_cb_t ms_cb, clock_seconds_cb_t seconds_cb)
+{
+  override_ms = ms_cb;
+  override_seconds = seconds_cb;
+}
+
+bool game_clock_is_virtual()
+{
+  return override_ms != nullptr;
+}
+
+uint32_t game_clock_millis()
+{
+  return override_ms ? override_ms() : millis();
+}
+
+int game_clock_seconds()
+{
+  return override_seconds ? override_seconds() : get_elapsed_seconds();
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// Time source for the game logic: millis() for grouping and the stopwatch for
+// history timestamps. The replay engine swaps in a virtual clock so recorded
+// games run through the real code much faster than real time.
+
+typedef uint32_t (*clock_ms_cb_t)();
+typedef int (*clock_seconds_cb_t)();
+
+// nullptr for both restores the real clock
+void game_clock_override(clock_ms_cb_t ms_cb, clock_seconds_cb_t seconds_cb);
+bool game_clock_is_virtual();
+uint32_t game_clock_millis();
+int game_clock_seconds();
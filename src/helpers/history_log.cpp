@@ -0,0 +1,114 @@
+#include "history_log.h"
+
+void HistoryLog::append(const LifeHistoryEvent &evt)
+{
+  uint8_t buf[4 * VARINT_MAX_BYTES];
+  size_t n = 0;
+  n += varint_encode(buf + n, zigzag_encode(evt.net_life_change));
+  if (count % HISTORY_KEYFRAME_INTERVAL == 0)
+  {
+    keyframes.push_back(data.size());
+    n += varint_encode(buf + n, zigzag_encode(evt.life_total));
+    n += varint_encode(buf + n, evt.timestamp);
+    n += varint_encode(buf + n, zigzag_encode(evt.change_timestamp));
+  }
+  else
+  {
+    // Boot-time steps wrap like the millis() they come from
+    n += varint_encode(buf + n, evt.timestamp - newest.timestamp);
+    n += varint_encode(buf + n, zigzag_encode(evt.change_timestamp - newest.change_timestamp));
+  }
+  data.insert(data.end(), buf, buf + n);
+  newest = evt;
+  newest.player_id = player_id;
+  count++;
+}
+
+bool HistoryLog::removeLast(LifeHistoryEvent &removed)
+{
+  if (count == 0)
+    return false;
+  size_t index = count - 1;
+  removed = newest;
+  if (index == 0)
+  {
+    clear();
+    return true;
+  }
+  // Decoding the previous event leaves the reader at the start of the newest one
+  HistoryCursor c = cursor(index - 1);
+  LifeHistoryEvent previous;
+  if (!c.next(previous))
+    return false;
+  data.resize(c.reader.pos);
+  if (index % HISTORY_KEYFRAME_INTERVAL == 0)
+    keyframes.pop_back();
+  newest = previous;
+  count--;
+  return true;
+}
+
+void HistoryLog::clear()
+{
+  count = 0;
+  data.clear();
+  data.shrink_to_fit();
+  keyframes.clear();
+  keyframes.shrink_to_fit();
+  newest = {0, 0, player_id, 0, 0};
+}
+
+HistoryCursor HistoryLog::cursor(size_t start) const
+{
+  HistoryCursor c;
+  c.log = this;
+  c.reader = {data.data(), data.size(), 0, false};
+  if (start >= count)
+  {
+    c.position = count;
+    return c;
+  }
+  size_t key = start / HISTORY_KEYFRAME_INTERVAL;
+  c.reader.pos = keyframes[key];
+  c.position = key * HISTORY_KEYFRAME_INTERVAL;
+  LifeHistoryEvent skipped;
+  while (c.position < start && c.next(skipped))
+    ;
+  return c;
+}
+
+bool HistoryCursor::next(LifeHistoryEvent &evt)
+{
+  if (!log || position >= log->count || reader.error)
+    return false;
+  evt.net_life_change = varint_get_s(reader);
+  if (position % HISTORY_KEYFRAME_INTERVAL == 0)
+  {
+    evt.life_total = varint_get_s(reader);
+    evt.timestamp = varint_get_u(reader);
+    evt.change_timestamp = varint_get_s(reader);
+  }
+  else
+  {
+    evt.life_total = prev.life_total + evt.net_life_change;
+    evt.timestamp = prev.timestamp + varint_get_u(reader);
+    evt.change_timestamp = prev.change_timestamp + varint_get_s(reader);
+  }
+  if (reader.error)
+    return false;
+  evt.player_id = log->player_id;
+  prev = evt;
+  position++;
+  return true;
+}
+
+std::vector<LifeHistoryEvent> HistoryLog::toVector() const
+{
+  std::vector<LifeHistoryEvent> events;
+  events.reserve(count);
+  HistoryCursor c = cursor();
+  LifeHistoryEvent evt;
+  while (c.next(evt))
+    events.push_back(evt);
+  return events;
+}
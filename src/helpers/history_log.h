@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "helpers/varint.h"
+
+struct LifeHistoryEvent
+{
+  int net_life_change;
+  int life_total;
+  int player_id;        // 0 for single, 1/2 for 2P
+  uint32_t timestamp;   // Time since boot
+  int change_timestamp; // seconds since game started
+};
+
+// Compact history of one player. Events are stored as varint deltas (life change,
+// game-time step, boot-time step; the total is implied) at about 4-5 bytes each
+// instead of 20. Every HISTORY_KEYFRAME_INTERVAL events a keyframe stores the
+// absolute values, so decoding can start there instead of at the first event.
+
+#define HISTORY_KEYFRAME_INTERVAL 64
+
+class HistoryLog;
+
+// Streaming decoder, one event at a time. Any change to the log invalidates it.
+class HistoryCursor
+{
+public:
+  bool next(LifeHistoryEvent &evt);
+  size_t index() const { return position; }
+
+private:
+  friend class HistoryLog;
+  const HistoryLog *log = nullptr;
+  VarintReader reader = {nullptr, 0, 0, false};
+  size_t position = 0;
+  LifeHistoryEvent prev = {0, 0, 0, 0, 0};
+};
+
+class HistoryLog
+{
+public:
+  explicit HistoryLog(int player_id = 0) : player_id(player_id) {}
+
+  void append(const LifeHistoryEvent &evt);
+  // Drops the newest event into `removed`. Only the events since the last keyframe
+  // are decoded, so the cost does not grow with the history.
+  bool removeLast(LifeHistoryEvent &removed);
+  void clear();
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_t byteSize() const { return data.size() + keyframes.size() * sizeof(uint32_t); }
+  // Newest event, kept decoded; only valid when the log is not empty
+  const LifeHistoryEvent &last() const { return newest; }
+  // Decoder positioned on event `start`, seeking from the nearest keyframe
+  HistoryCursor cursor(size_t start = 0) const;
+  // Decodes everything; prefer cursor() for long histories
+  std::vector<LifeHistoryEvent> toVector() const;
+
+private:
+  friend class HistoryCursor;
+  int player_id;
+  size_t count = 0;
+  std::vector<uint8_t> data;
+  std::vector<uint32_t> keyframes; // byte offset of event k * HISTORY_KEYFRAME_INTERVAL
+  LifeHistoryEvent newest = {0, 0, 0, 0, 0};
+};
@@ -0,0 +1,97 @@
+#include "polar_zones.h"
+#include <math.h>
+#include <stdio.h>
+#include "log/log.h"
+
+PolarZoneMap menu_zone_map;
+PolarZoneMap tap_zone_map;
+
+static const PolarLayout menu_layout = {
+    2,
+    {
+        {SCREEN_DIAMETER / 6, 1, 0},     // center cancel hole
+        {SCREEN_DIAMETER / 2 + 1, 4, 180} // TL, TR, BR, BL
+    }};
+
+static const PolarLayout tap_layout = {
+    1,
+    {
+        {0xFFFF, 4, 180} // whole screen including corners: TL, TR, BR, BL
+    }};
+
+static_assert((SCREEN_DIAMETER / 2) % POLAR_CELL_SIZE == 0, "POLAR_CELL_SIZE must divide the radius");
+
+// Zone of one pixel. The radius is tested on whole pixels like the hit tests
+// this replaced (dx * dx + dy * dy < r * r); the angle from the pixel center, so
+// no pixel sits on a quadrant line.
+static uint8_t zone_at(const PolarLayout &layout, int x, int y)
+{
+  const int center = SCREEN_DIAMETER / 2;
+  int dx = x - center;
+  int dy = y - center;
+  uint32_t dist_sq = (uint32_t)(dx * dx + dy * dy);
+  uint8_t zone_base = 0;
+  for (int r = 0; r < layout.ring_count; ++r)
+  {
+    const PolarRing &ring = layout.rings[r];
+    if (dist_sq < (uint32_t)ring.outer_radius * ring.outer_radius)
+    {
+      float angle = atan2f(dy + 0.5f, dx + 0.5f) * 180.0f / M_PI;
+      float rel = angle - ring.start_angle;
+      while (rel < 0)
+        rel += 360.0f;
+      while (rel >= 360.0f)
+        rel -= 360.0f;
+      int sector = (int)(rel * ring.sectors / 360.0f);
+      if (sector >= ring.sectors)
+        sector = ring.sectors - 1;
+      return zone_base + sector;
+    }
+    zone_base += ring.sectors;
+  }
+  return POLAR_ZONE_NONE;
+}
+
+// Float math is fine here, this only runs once at boot. Zones are convex enough
+// at this cell size that a cell whose corner pixels agree lies in one zone.
+void polar_zone_map_build(PolarZoneMap *map, const PolarLayout &layout)
+{
+  const int last = POLAR_CELL_SIZE - 1;
+  map->layout = &layout;
+  for (int row = 0; row < POLAR_GRID_SIZE; ++row)
+  {
+    for (int col = 0; col < POLAR_GRID_SIZE; ++col)
+    {
+      int x = col * POLAR_CELL_SIZE;
+      int y = row * POLAR_CELL_SIZE;
+      uint8_t zone = zone_at(layout, x, y);
+      if (zone_at(layout, x + last, y) != zone || zone_at(layout, x, y + last) != zone ||
+          zone_at(layout, x + last, y + last) != zone)
+        zone = POLAR_ZONE_EDGE;
+      map->cells[row * POLAR_GRID_SIZE + col] = zone;
+    }
+  }
+}
+
+uint8_t polar_zone_lookup(const PolarZoneMap *map, lv_coord_t x, lv_coord_t y)
+{
+  if (x < 0 || y < 0)
+    return POLAR_ZONE_NONE;
+  int col = x / POLAR_CELL_SIZE;
+  int row = y / POLAR_CELL_SIZE;
+  if (col >= POLAR_GRID_SIZE || row >= POLAR_GRID_SIZE)
+    return POLAR_ZONE_NONE;
+  uint8_t zone = map->cells[row * POLAR_GRID_SIZE + col];
+  return zone == POLAR_ZONE_EDGE ? zone_at(*map->layout, x, y) : zone;
+}
+
+void polar_zones_init()
+{
+  static bool initialized = false;
+  if (initialized)
+    return;
+  polar_zone_map_build(&menu_zone_map, menu_layout);
+  polar_zone_map_build(&tap_zone_map, tap_layout);
+  initialized = true;
+  LOG_D(UI, "[polar_zones_init] Built %dx%d zone maps (%u bytes each)\n", POLAR_GRID_SIZE, POLAR_GRID_SIZE, (unsigned)sizeof(PolarZoneMap));
+}
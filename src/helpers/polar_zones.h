@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <lvgl.h>
+#include "constants/constants.h"
+
+// Precomputed polar hit-testing for the round screen.
+// The 360x360 screen is downsampled into square cells and each cell stores a
+// zone ID, so a touch is resolved with a table read. The cell size divides the
+// radius, so the quadrant lines through the center fall on cell edges; the few
+// cells a ring boundary cuts through are marked and resolved exactly per pixel.
+
+#define POLAR_CELL_SIZE 6 // px, must divide SCREEN_DIAMETER / 2
+#define POLAR_GRID_SIZE (SCREEN_DIAMETER / POLAR_CELL_SIZE)
+#define POLAR_MAX_RINGS 4
+#define POLAR_ZONE_NONE 0xFF
+#define POLAR_ZONE_EDGE 0xFE // cell spans more than one zone
+
+// One ring of the layout. Rings are listed from the center outwards and each
+// ring covers [previous outer_radius, outer_radius). Angles follow LVGL:
+// 0 = 3 o'clock, increasing clockwise.
+struct PolarRing
+{
+  uint16_t outer_radius;
+  uint8_t sectors;     // 1 = whole ring is a single zone
+  int16_t start_angle; // where sector 0 begins
+};
+
+struct PolarLayout
+{
+  uint8_t ring_count;
+  PolarRing rings[POLAR_MAX_RINGS];
+};
+
+struct PolarZoneMap
+{
+  const PolarLayout *layout; // for the edge cells
+  uint8_t cells[POLAR_GRID_SIZE * POLAR_GRID_SIZE];
+};
+
+// Zone IDs are assigned ring by ring: ring 0 sectors first, then ring 1, etc.
+// The layout must outlive the map
+void polar_zone_map_build(PolarZoneMap *map, const PolarLayout &layout);
+uint8_t polar_zone_lookup(const PolarZoneMap *map, lv_coord_t x, lv_coord_t y);
+
+// Shared layouts, built once at boot by polar_zones_init()
+// Contextual menu: center cancel hole + 4 sectors (TL, TR, BR, BL)
+#define MENU_ZONE_CANCEL 0
+#define MENU_ZONE_TL 1
+#define MENU_ZONE_TR 2
+#define MENU_ZONE_BR 3
+#define MENU_ZONE_BL 4
+
+// Gestures: 4 sectors covering the whole screen (TL, TR, BR, BL)
+#define TAP_ZONE_TL 0
+#define TAP_ZONE_TR 1
+#define TAP_ZONE_BR 2
+#define TAP_ZONE_BL 3
+
+extern PolarZoneMap menu_zone_map;
+extern PolarZoneMap tap_zone_map;
+
+void polar_zones_init();
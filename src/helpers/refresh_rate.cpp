@@ -0,0 +1,136 @@
+#include "refresh_rate.h"
+#include <stdio.h>
+#include "log/log.h"
+
+static lv_display_t *refresh_display = nullptr;
+static lv_indev_t *refresh_indev = nullptr;
+static lv_timer_t *control_timer = nullptr;
+// Both read by the touch ISR, so kept in DRAM
+static DRAM_ATTR TaskHandle_t gui_task_handle = nullptr;
+static DRAM_ATTR volatile bool touch_pending = false;
+static bool idle = false;
+static bool final_frame = false; // going idle once the refresh timer has drawn
+static bool frozen = false;
+static bool held = false;
+
+static void refresh_go_active()
+{
+  lv_timer_t *refr_timer = lv_display_get_refr_timer(refresh_display);
+  lv_timer_t *read_timer = lv_indev_get_read_timer(refresh_indev);
+  lv_timer_set_period(refr_timer, REFRESH_ACTIVE_PERIOD_MS);
+  lv_timer_set_period(read_timer, REFRESH_ACTIVE_PERIOD_MS);
+  lv_timer_resume(refr_timer);
+  lv_timer_resume(read_timer);
+  lv_timer_resume(control_timer);
+  if (idle)
+    LOG_D(DISPLAY, "[refresh_rate] active\n");
+  idle = false;
+  final_frame = false;
+}
+
+// Stop polling, and have the refresh timer draw whatever is still pending on its
+// next run; refr_ready_event_cb pauses it after that frame
+static void refresh_go_idle()
+{
+  lv_timer_t *refr_timer = lv_display_get_refr_timer(refresh_display);
+  lv_timer_pause(lv_indev_get_read_timer(refresh_indev));
+  lv_timer_pause(control_timer);
+  final_frame = true;
+  lv_timer_resume(refr_timer);
+  lv_timer_ready(refr_timer);
+}
+
+static void refr_ready_event_cb(lv_event_t *e)
+{
+  if (!final_frame)
+    return;
+  final_frame = false;
+  lv_timer_pause(lv_display_get_refr_timer(refresh_display));
+  if (!idle)
+    LOG_D(DISPLAY, "[refresh_rate] idle\n");
+  idle = true;
+}
+
+static void control_timer_cb(lv_timer_t *t)
+{
+  bool busy = held || lv_anim_count_running() > 0 ||
+              lv_indev_get_state(refresh_indev) == LV_INDEV_STATE_PRESSED ||
+              lv_display_get_inactive_time(refresh_display) < REFRESH_SETTLE_MS;
+  if (busy)
+  {
+    if (idle)
+      refresh_go_active();
+    return;
+  }
+  refresh_go_idle();
+}
+
+// Something changed while idle (timer label, model flush, ...): let the controller
+// decide whether to draw it once or go back to full rate
+static void invalidate_event_cb(lv_event_t *e)
+{
+  if (!idle || frozen)
+    return;
+  lv_timer_resume(control_timer);
+  lv_timer_ready(control_timer);
+}
+
+void refresh_rate_init(lv_display_t *display, lv_indev_t *indev, TaskHandle_t gui_task)
+{
+  refresh_display = display;
+  refresh_indev = indev;
+  gui_task_handle = gui_task;
+  control_timer = lv_timer_create(control_timer_cb, REFRESH_CHECK_PERIOD_MS, NULL);
+  lv_display_add_event_cb(display, invalidate_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+  lv_display_add_event_cb(display, refr_ready_event_cb, LV_EVENT_REFR_READY, NULL);
+  refresh_go_active();
+}
+
+bool IRAM_ATTR refresh_rate_touch_from_isr(void)
+{
+  touch_pending = true;
+  if (!gui_task_handle)
+    return false;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(gui_task_handle, &woken);
+  return woken == pdTRUE;
+}
+
+void refresh_rate_poll(void)
+{
+  if (!touch_pending || !control_timer)
+    return;
+  touch_pending = false;
+  if (idle)
+  {
+    refresh_go_active();
+    lv_timer_ready(lv_indev_get_read_timer(refresh_indev));
+  }
+}
+
+bool refresh_rate_is_idle(void)
+{
+  return idle;
+}
+
+void refresh_rate_freeze(bool freeze)
+{
+  frozen = freeze;
+  if (frozen)
+    refresh_go_idle();
+  else
+    refresh_go_active();
+}
+
+void refresh_rate_notify(void)
+{
+  if (gui_task_handle)
+    xTaskNotifyGive(gui_task_handle);
+}
+
+void refresh_rate_hold(bool hold)
+{
+  held = hold;
+  if (held && (idle || final_frame))
+    refresh_go_active();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <lvgl.h>
+#include <Arduino.h>
+
+// Adaptive refresh: display refresh and touch polling run at the panel's rate
+// while something moves or a finger is down, and are paused once the UI has
+// settled. Invalidations and the touch interrupt bring them back.
+
+#define REFRESH_ACTIVE_PERIOD_MS 16 // ~60 fps, panel maximum
+#define REFRESH_CHECK_PERIOD_MS 100 // how often the controller looks for idleness
+#define REFRESH_SETTLE_MS 500       // input quiet time before going idle
+#define REFRESH_MAX_SLEEP_MS 1000   // upper bound for the GUI task wait
+
+void refresh_rate_init(lv_display_t *display, lv_indev_t *indev, TaskHandle_t gui_task);
+// Called from the touch interrupt; returns true if a higher priority task was woken
+bool refresh_rate_touch_from_isr(void);
+// Called by the GUI task after each wait, picks up touch interrupts
+void refresh_rate_poll(void);
+bool refresh_rate_is_idle(void);
+// Frozen: render once, then stay paused and ignore invalidations until unfrozen
+// or a touch arrives (used by the always-on display)
+void refresh_rate_freeze(bool frozen);
+// Wake the GUI task from another task (e.g. the power key)
+void refresh_rate_notify(void);
+// Held: stay at full rate regardless of activity (e.g. while replaying touches)
+void refresh_rate_hold(bool hold);
@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// LEB128 varints with zigzag for signed values, shared by the history codec and
+// the RTC snapshot. Small deltas (the common case) take a single byte.
+
+#define VARINT_MAX_BYTES 5 // a full 32-bit value
+
+inline uint32_t zigzag_encode(int32_t v)
+{
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t zigzag_decode(uint32_t v)
+{
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Writes v to out (room for VARINT_MAX_BYTES) and returns the byte count
+inline size_t varint_encode(uint8_t *out, uint32_t v)
+{
+  size_t n = 0;
+  do
+  {
+    uint8_t b = v & 0x7F;
+    v >>= 7;
+    if (v)
+      b |= 0x80;
+    out[n++] = b;
+  } while (v);
+  return n;
+}
+
+struct VarintReader
+{
+  const uint8_t *buf;
+  size_t len;
+  size_t pos;
+  bool error; // set on truncated or over-long input, reads then return 0
+};
+
+inline uint32_t varint_get_u(VarintReader &r)
+{
+  uint32_t v = 0;
+  for (int shift = 0; shift < 35; shift += 7)
+  {
+    if (r.pos >= r.len)
+    {
+      r.error = true;
+      return 0;
+    }
+    uint8_t b = r.buf[r.pos++];
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80))
+      return v;
+  }
+  r.error = true;
+  return 0;
+}
+
+inline int32_t varint_get_s(VarintReader &r)
+{
+  return zigzag_decode(varint_get_u(r));
+}
@@ -5,36 +5,48 @@
 #include <state/state_store.h>
 #include <life/life_counter.h>
 #include <life/life_counter2P.h>
+#include <theme/theme.h>
+#include <log/log.h>
 
 extern lv_obj_t *history_menu;
 
-void renderHistoryOverlay()
+static void addHistoryRow(lv_obj_t *table, PlayerMode player_mode, size_t row_idx, const LifeHistoryEvent &evt)
 {
-  teardownHistoryOverlay(); // Clean up previous overlay if it exists
-  PlayerMode player_mode = (PlayerMode)player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER);
-  std::vector<LifeHistoryEvent> history;
-  if (player_mode == PLAYER_MODE_ONE_PLAYER)
+  // format the time
+  char time_buf[32];
+  snprintf(time_buf, sizeof(time_buf), "%02d:%02d", evt.change_timestamp / 60, evt.change_timestamp % 60);
+  int life_change = evt.net_life_change;
+  int life_total = evt.life_total;
+  char buf[64] = "";
+  if (player_mode == PLAYER_MODE_ONE_PLAYER && evt.player_id == PLAYER_SINGLE)
   {
-    history = event_grouper.getHistory();
+    if (life_change > 0)
+      snprintf(buf, sizeof(buf), "+%d@%s[%d]", life_change, time_buf, life_total);
+    else if (life_change <= 0)
+      snprintf(buf, sizeof(buf), "%d@%s[%d]", life_change, time_buf, life_total);
+    lv_table_set_cell_value(table, row_idx, 0, buf);
   }
   else
   {
-    // 2P mode: merge and sort both groupers
-    std::vector<LifeHistoryEvent> h1 = event_grouper_p1.getHistory();
-    std::vector<LifeHistoryEvent> h2 = event_grouper_p2.getHistory();
-    history.reserve(h1.size() + h2.size());
-    history.insert(history.end(), h1.begin(), h1.end());
-    history.insert(history.end(), h2.begin(), h2.end());
-    std::sort(history.begin(), history.end(), [](const LifeHistoryEvent &a, const LifeHistoryEvent &b)
-              { return a.timestamp < b.timestamp; });
+    // Two player mode, two columns
+    char p1_buf[64] = "";
+    char p2_buf[64] = "";
+    if (life_change > 0)
+      snprintf(evt.player_id == PLAYER_ONE ? p1_buf : p2_buf, sizeof(p1_buf), "+%d@%s[%d]", life_change, time_buf, life_total);
+    else if (life_change <= 0)
+      snprintf(evt.player_id == PLAYER_ONE ? p1_buf : p2_buf, sizeof(p1_buf), "%d@%s[%d]", life_change, time_buf, life_total);
+    lv_table_set_cell_value(table, row_idx, 0, p1_buf);
+    lv_table_set_cell_value(table, row_idx, 1, p2_buf);
   }
+}
+
+void renderHistoryOverlay()
+{
+  teardownHistoryOverlay(); // Clean up previous overlay if it exists
+  PlayerMode player_mode = (PlayerMode)player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER);
   history_menu = lv_obj_create(lv_scr_act());
   lv_obj_set_size(history_menu, SCREEN_WIDTH, SCREEN_HEIGHT);
-  lv_obj_set_style_bg_color(history_menu, BLACK_COLOR, LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(history_menu, LV_OPA_COVER, LV_PART_MAIN);
-  lv_obj_set_style_border_opa(history_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_outline_opa(history_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_radius(history_menu, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+  lv_obj_add_style(history_menu, &style_round_overlay, LV_PART_MAIN);
   lv_obj_set_scrollbar_mode(history_menu, LV_SCROLLBAR_MODE_OFF);
   lv_obj_remove_flag(history_menu, LV_OBJ_FLAG_SCROLLABLE); // Disable scrolling
 
@@ -45,26 +57,21 @@ void renderHistoryOverlay()
   // Back button (row 0)
   lv_obj_t *btn_back = lv_btn_create(history_menu);
   lv_obj_set_size(btn_back, 100, 60);
-  lv_obj_set_style_bg_color(btn_back, lv_color_white(), LV_PART_MAIN);
+  lv_obj_add_style(btn_back, &style_back_button, LV_PART_MAIN);
   lv_obj_set_style_border_width(btn_back, 2, LV_PART_MAIN);
   lv_obj_set_grid_cell(btn_back, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_START, 0, 1);
 
   lv_obj_t *lbl_back = lv_label_create(btn_back);
   lv_label_set_text(lbl_back, LV_SYMBOL_LEFT " Back");
-  lv_obj_set_style_text_font(lbl_back, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_back, &style_back_label, 0);
   lv_obj_center(lbl_back);
-  lv_obj_set_style_text_color(lbl_back, lv_color_black(), 0);
   lv_obj_add_event_cb(btn_back, [](lv_event_t *e)
                       { renderMenu(MENU_CONTEXTUAL, false); }, LV_EVENT_CLICKED, NULL);
   // Table
   lv_obj_t *table = lv_table_create(history_menu);
   // Place table in col 0, row 1, spanning 1 col and 1 row, stretched to fill cell
   lv_obj_set_grid_cell(table, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_STRETCH, 1, 1);
-  lv_obj_set_style_radius(table, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-  lv_obj_set_style_border_opa(table, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_outline_opa(table, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(table, lv_color_black(), LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(table, LV_OPA_COVER, LV_PART_MAIN);
+  lv_obj_add_style(table, &style_table, LV_PART_MAIN);
   lv_obj_set_scroll_dir(table, LV_DIR_VER);
   if (player_mode == PLAYER_MODE_ONE_PLAYER)
   {
@@ -128,40 +135,44 @@ void renderHistoryOverlay()
   lv_obj_add_event_cb(table, draw_event_cb, LV_EVENT_DRAW_TASK_ADDED, NULL);
   lv_obj_add_flag(table, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
 
-  // Build table rows
-  for (size_t i = 0; i < history.size(); ++i)
+  // Build table rows, decoding the compact histories as we go
+  size_t row_idx = 1; // row 0 is header
+  LifeHistoryEvent evt;
+  if (player_mode == PLAYER_MODE_ONE_PLAYER)
   {
-    const LifeHistoryEvent &evt = history[i];
-    // format the time
-    char time_buf[32];
-    printf("[renderHistoryOverlay] Event %zu: player_id=%d, timestamp=%u\n", i, evt.player_id, evt.timestamp);
-    snprintf(time_buf, sizeof(time_buf), "%02d:%02d", evt.change_timestamp / 60, evt.change_timestamp % 60);
-    int life_change = evt.net_life_change;
-    int life_total = evt.life_total;
-    char buf[64] = "";
-    size_t row_idx = i + 1; // row 0 is header
-    if (player_mode == PLAYER_MODE_ONE_PLAYER && evt.player_id == PLAYER_SINGLE)
-    {
-      if (life_change > 0)
-        snprintf(buf, sizeof(buf), "+%d@%s[%d]", life_change, time_buf, life_total);
-      else if (life_change <= 0)
-        snprintf(buf, sizeof(buf), "%d@%s[%d]", life_change, time_buf, life_total);
-      lv_table_set_row_cnt(table, row_idx + 1);
-      lv_table_set_cell_value(table, row_idx, 0, buf);
-    }
-    else
+    const HistoryLog &log = event_grouper.getHistoryLog();
+    lv_table_set_row_cnt(table, log.size() + 1);
+    HistoryCursor cursor = log.cursor();
+    while (cursor.next(evt))
+      addHistoryRow(table, player_mode, row_idx++, evt);
+    LOG_D(UI, "[renderHistoryOverlay] %u events from %u bytes\n", (unsigned)log.size(), (unsigned)log.byteSize());
+  }
+  else
+  {
+    // 2P mode: merge both histories by timestamp
+    const HistoryLog &log_p1 = event_grouper_p1.getHistoryLog();
+    const HistoryLog &log_p2 = event_grouper_p2.getHistoryLog();
+    lv_table_set_row_cnt(table, log_p1.size() + log_p2.size() + 1);
+    HistoryCursor cursor_p1 = log_p1.cursor();
+    HistoryCursor cursor_p2 = log_p2.cursor();
+    LifeHistoryEvent evt_p2;
+    bool has_p1 = cursor_p1.next(evt);
+    bool has_p2 = cursor_p2.next(evt_p2);
+    while (has_p1 || has_p2)
     {
-      // Two player mode, two columns
-      char p1_buf[64] = "";
-      char p2_buf[64] = "";
-      if (life_change > 0)
-        snprintf(evt.player_id == PLAYER_ONE ? p1_buf : p2_buf, sizeof(p1_buf), "+%d@%s[%d]", life_change, time_buf, life_total);
-      else if (life_change <= 0)
-        snprintf(evt.player_id == PLAYER_ONE ? p1_buf : p2_buf, sizeof(p1_buf), "%d@%s[%d]", life_change, time_buf, life_total);
-      lv_table_set_row_cnt(table, row_idx + 1);
-      lv_table_set_cell_value(table, row_idx, 0, p1_buf);
-      lv_table_set_cell_value(table, row_idx, 1, p2_buf);
+      if (has_p1 && (!has_p2 || evt.timestamp < evt_p2.timestamp))
+      {
+        addHistoryRow(table, player_mode, row_idx++, evt);
+        has_p1 = cursor_p1.next(evt);
+      }
+      else
+      {
+        addHistoryRow(table, player_mode, row_idx++, evt_p2);
+        has_p2 = cursor_p2.next(evt_p2);
+      }
     }
+    LOG_D(UI, "[renderHistoryOverlay] %u events from %u bytes\n", (unsigned)(log_p1.size() + log_p2.size()),
+           (unsigned)(log_p1.byteSize() + log_p2.byteSize()));
   }
 }
 
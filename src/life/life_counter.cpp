@@ -10,6 +10,11 @@
 #include <menu/menu.h>
 #include "constants/constants.h"
 #include <timer/timer.h>
+#include <state/life_model.h>
+#include <state/journal.h>
+#include <helpers/arc_update.h>
+#include <theme/theme.h>
+#include <log/log.h>
 
 // --- Life Counter GUI State ---
 lv_obj_t *life_counter_container = nullptr; // Global for menu access
@@ -18,34 +23,34 @@ static lv_obj_t *life_arc = nullptr;
 static lv_obj_t *life_label = nullptr;
 static lv_obj_t *grouped_change_label = nullptr;
 static lv_obj_t *lbl_amp_label = nullptr;
-static int amp_value = 0;
 static int peak_amp = 8;
 
 EventGrouper event_grouper(GROUPER_WINDOW, player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX), PLAYER_SINGLE); // Single player mode
 
 // --- Forward Declarations ---
 void update_life_label(int value);
+static void life_arc_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void pending_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void amp_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
 static void arc_sweep_anim_cb(void *var, int32_t value);
 static void arc_sweep_anim_ready_cb(lv_anim_t *anim);
+static void register_life_counter_gestures();
 void lvgl_gesture_event_handler(lv_event_t *e);
 static lv_color_t interpolate_color(lv_color_t c1, lv_color_t c2, uint8_t t);
 void increment_life(int value);
 void decrement_life(int value);
 void reset_life();
 void queue_life_change(int player, int value);
+void undo_life_change();
 void increment_amp();
 void clear_amp();
 
 // Static flag to track initialization state
 static bool is_initializing = false;
 
-// Call this after boot animation to show the life counter
-void init_life_counter()
+// Create the life counter widgets (hidden/transparent) if they do not exist yet
+static void create_life_counter_widgets()
 {
-  is_initializing = true;  // Set flag to indicate initialization is active
-  teardown_life_counter(); // Clean up any previous state
-  event_grouper.resetHistory(player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX));
-  int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
   int amp_mode = player_store.getInt(KEY_AMP_MODE, PLAYER_SINGLE);
 
   // Create a container for the life counter UI if it doesn't exist
@@ -57,10 +62,8 @@ void init_life_counter()
     lv_obj_clear_flag(life_counter_container, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_clear_flag(life_counter_container, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_set_scrollbar_mode(life_counter_container, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_bg_opa(life_counter_container, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_opa(life_counter_container, LV_OPA_TRANSP, 0);
-    // Remove default padding to prevent grid shift
-    lv_obj_set_style_pad_all(life_counter_container, 0, 0);
+    // No default padding, it would shift the grid
+    lv_obj_add_style(life_counter_container, &style_bare_container, 0);
     // Set up grid: 1 column, 3 rows centered on screen
     // Row heights adjusted so row 1 (life_label) is centered at y=180
     static lv_coord_t col_dsc[] = {LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
@@ -77,13 +80,12 @@ void init_life_counter()
     lv_obj_align(life_arc, LV_ALIGN_CENTER, 0, 0);
     lv_arc_set_bg_angles(life_arc, 0, 360);
     lv_arc_set_angles(life_arc, 270, 270);
-    lv_obj_set_style_arc_color(life_arc, GREEN_COLOR, LV_PART_INDICATOR);
-    lv_obj_set_style_arc_opa(life_arc, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(life_arc, 0, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(life_arc, ARC_WIDTH, LV_PART_INDICATOR);
+    lv_obj_add_style(life_arc, &style_life_arc_main, LV_PART_MAIN);
+    lv_obj_add_style(life_arc, &style_life_arc_indicator, LV_PART_INDICATOR);
     // lv_obj_set_style_arc_rounded(life_arc, 0, LV_PART_INDICATOR); // Square ends
     lv_obj_remove_style(life_arc, NULL, LV_PART_KNOB);
     lv_obj_clear_flag(life_arc, LV_OBJ_FLAG_CLICKABLE);
+    lv_subject_add_observer_obj(life_model_subject_total(PLAYER_SINGLE), life_arc_observer_cb, life_arc, NULL);
   }
   if (!life_label)
   {
@@ -94,10 +96,11 @@ void init_life_counter()
       lv_obj_set_style_text_font(life_label, &lv_font_montserrat_48, 0); // Use smaller font for large numbers
     else
       lv_obj_set_style_text_font(life_label, &lv_font_montserrat_72, 0); // Default large font
-    lv_obj_set_style_text_color(life_label, lv_color_white(), 0);
+    lv_obj_add_style(life_label, &style_life_label, 0);
     lv_obj_align(life_label, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_style_text_opa(life_label, LV_OPA_TRANSP, 0); // Start transparent
     lv_obj_set_grid_cell(life_label, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
+    lv_label_bind_text(life_label, life_model_subject_total(PLAYER_SINGLE), "%d");
   }
   if (!grouped_change_label)
   {
@@ -105,9 +108,9 @@ void init_life_counter()
     grouped_change_label = lv_label_create(life_counter_container);
     lv_obj_add_flag(grouped_change_label, LV_OBJ_FLAG_HIDDEN);
     lv_label_set_text(grouped_change_label, "0");
-    lv_obj_set_style_text_font(grouped_change_label, &lv_font_montserrat_40, 0);
-    lv_obj_set_style_text_color(grouped_change_label, lv_color_white(), 0);
+    lv_obj_add_style(grouped_change_label, &style_change_label, 0);
     lv_obj_set_grid_cell(grouped_change_label, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_END, 0, 1);
+    lv_subject_add_observer_obj(life_model_subject_pending(PLAYER_SINGLE), pending_observer_cb, grouped_change_label, NULL);
   }
   // Create amp button if not already created
   if (!amp_button)
@@ -129,12 +132,10 @@ void init_life_counter()
                         {
         if (!amp_long_press) increment_amp(); }, LV_EVENT_CLICKED, NULL);
     lbl_amp_label = lv_label_create(amp_button);
-    char buf[8];
-    snprintf(buf, sizeof(buf), "%d", amp_value);
-    lv_label_set_text(lbl_amp_label, buf);
     lv_obj_set_style_text_color(lbl_amp_label, WHITE_COLOR, 0);
     lv_obj_set_style_text_font(lbl_amp_label, &lv_font_montserrat_36, 0);
     lv_obj_center(lbl_amp_label);
+    lv_subject_add_observer_obj(life_model_subject_amp(), amp_observer_cb, amp_button, NULL);
     // Position absolutely to the right of screen center (life_label is centered)
     // Button is 110px wide, so half is 55px. Position center of button right of screen center with gap
     lv_obj_align(amp_button, LV_ALIGN_CENTER, 115, 0);
@@ -150,6 +151,18 @@ void init_life_counter()
       lv_obj_add_flag(amp_button, LV_OBJ_FLAG_HIDDEN);
     }
   }
+}
+
+// Call this after boot animation to show the life counter
+void init_life_counter()
+{
+  is_initializing = true;  // Set flag to indicate initialization is active
+  teardown_life_counter(); // Clean up any previous state
+  event_grouper.resetHistory(player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX));
+  int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
+  journal_reset(PLAYER_SINGLE, max_life);
+  create_life_counter_widgets();
+
   // Show arc and animate sweep while fading in the life label in parallel
   if (life_arc)
   {
@@ -157,13 +170,13 @@ void init_life_counter()
     lv_obj_set_style_arc_opa(life_arc, LV_OPA_COVER, LV_PART_INDICATOR);
     lv_anim_t anim;
     lv_anim_init(&anim);
-    lv_anim_set_var(&anim, NULL);
+    lv_anim_set_var(&anim, life_arc); // keyed on the arc so teardown cancels it
     lv_anim_set_exec_cb(&anim, arc_sweep_anim_cb);
     lv_anim_set_values(&anim, 0, max_life);
     lv_anim_set_time(&anim, 1500);
     lv_anim_set_delay(&anim, 0);
     lv_anim_set_ready_cb(&anim, arc_sweep_anim_ready_cb);
-    lv_anim_start(&anim);
+    anim_start_keyed(&anim);
   }
 
   if (life_label)
@@ -181,32 +194,79 @@ void init_life_counter()
   }
 }
 
-void increment_amp()
+// Build the view ahead of time so a mode switch only has to unhide it
+void prebuild_life_counter()
 {
-  amp_value += 1;
-  char buf[8];
-  snprintf(buf, sizeof(buf), "+%d", amp_value);
-  if (amp_button && lbl_amp_label)
+  if (life_counter_container)
+    return;
+  create_life_counter_widgets();
+  lv_obj_add_flag(life_counter_container, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Show the view with its current game state, skipping the boot sweep and fades
+void resume_life_counter()
+{
+  prebuild_life_counter();
+  lv_obj_clear_flag(life_counter_container, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_clear_flag(life_arc, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_set_style_arc_opa(life_arc, LV_OPA_COVER, LV_PART_INDICATOR);
+  lv_anim_delete(life_label, NULL);
+  lv_obj_clear_flag(life_label, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_set_style_text_opa(life_label, LV_OPA_COVER, 0);
+  lv_anim_delete(amp_button, NULL);
+  if (player_store.getInt(KEY_AMP_MODE, PLAYER_SINGLE))
   {
-    lv_label_set_text(lbl_amp_label, buf);
-    // the closer amp gets to peak_amp, the more red it becomes
-    uint8_t t = (uint8_t)(((amp_value > peak_amp ? peak_amp : amp_value) * 255) / peak_amp); // Scale t from 0 to 255
-    if (t > 255)
-      t = 255; // Clamp to max 255
-    lv_color_t amp_color = interpolate_color(AMP_START_COLOR, AMP_END_COLOR, t);
-    lv_obj_set_style_bg_color(amp_button, amp_color, 0);
+    lv_obj_set_style_opa(amp_button, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(amp_button, LV_OBJ_FLAG_HIDDEN);
+  }
+  else
+  {
+    lv_obj_add_flag(amp_button, LV_OBJ_FLAG_HIDDEN);
+  }
+  update_life_label(event_grouper.getLifeTotal() + event_grouper.getPendingChange());
+
+  // Carry the running timer over from the other view
+  if (player_store.getInt(KEY_SHOW_TIMER, 0))
+  {
+    attach_timer(life_counter_container);
+    lv_obj_set_grid_cell(timer_container, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_CENTER, 2, 1);
   }
+  is_initializing = false;
+  clear_gesture_callbacks();
+  register_life_counter_gestures();
+}
+
+// Hide the view but keep its widgets and game state for the next switch
+void suspend_life_counter()
+{
+  if (life_counter_container)
+    lv_obj_add_flag(life_counter_container, LV_OBJ_FLAG_HIDDEN);
+}
+
+void increment_amp()
+{
+  life_model_set_amp(life_model_get_amp() + 1);
 }
 
 void clear_amp()
 {
-  amp_value = 0; // Reset amp value
-  char buf[8];
-  snprintf(buf, sizeof(buf), "%d", amp_value);
-  if (amp_button && lbl_amp_label)
+  life_model_set_amp(0); // Reset amp value
+}
+
+// Amp count into the amp button: text, and the closer to peak_amp the redder
+static void amp_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  lv_obj_t *button = lv_observer_get_target_obj(observer);
+  int amp_value = lv_subject_get_int(subject);
+  lv_obj_t *label = lv_obj_get_child(button, 0);
+  if (label)
   {
-    lv_label_set_text(lbl_amp_label, buf);
-    lv_obj_set_style_bg_color(amp_button, AMP_START_COLOR, 0);
+    char buf[8];
+    snprintf(buf, sizeof(buf), amp_value > 0 ? "+%d" : "%d", amp_value);
+    lv_label_set_text(label, buf);
+    uint8_t t = (uint8_t)(((amp_value > peak_amp ? peak_amp : amp_value) * 255) / peak_amp); // Scale t from 0 to 255
+    lv_color_t amp_color = interpolate_color(AMP_START_COLOR, AMP_END_COLOR, t);
+    lv_obj_set_style_bg_color(button, amp_color, 0);
   }
 }
 
@@ -231,6 +291,8 @@ void reset_life()
 {
   int life_value = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
   event_grouper.resetHistory(life_value);
+  journal_reset(PLAYER_SINGLE, life_value);
+  life_model_set_pending(PLAYER_SINGLE, 0);
   update_life_label(life_value);
 }
 
@@ -245,6 +307,7 @@ void teardown_life_counter()
   // Clean up previous objects if switching modes
   if (life_counter_container)
   {
+    anim_cancel(life_counter_container); // Drop sweeps and fades before their targets go away
     lv_obj_del(life_counter_container);
     life_counter_container = nullptr;
   }
@@ -291,6 +354,11 @@ static void arc_sweep_anim_cb(void *var, int32_t v)
 static void arc_sweep_anim_ready_cb(lv_anim_t *a)
 {
   is_initializing = false;
+  register_life_counter_gestures();
+}
+
+static void register_life_counter_gestures()
+{
   register_gesture_callback(GestureType::TapTop, []()
                             { increment_life(step_size_t::STEP_SIZE_SMALL); });
   register_gesture_callback(GestureType::TapBottom, []()
@@ -303,6 +371,14 @@ static void arc_sweep_anim_ready_cb(lv_anim_t *a)
                             {
                               if(getCurrentMenu() == MENU_NONE)
                                 renderMenu(MENU_CONTEXTUAL); });
+  register_gesture_callback(GestureType::SwipeUp, []()
+                            {
+                              if(getCurrentMenu() == MENU_NONE)
+                                undo_life_change(); });
+  register_gesture_callback(GestureType::SwipeRight, []()
+                            {
+                              if(getCurrentMenu() == MENU_NONE)
+                                redo_life_change(); });
 }
 
 // Function to convert life total to arc segment
@@ -384,28 +460,28 @@ static arc_segment_t life_to_arc(int life_total)
   return seg;
 }
 
-// Update the life label and arc based on the current life total
+// Record the displayed life total; the label and arc follow on the next flush
 void update_life_label(int new_life_total)
 {
-  if (life_label != nullptr)
-  {
-    char buf[8];
-    snprintf(buf, sizeof(buf), "%d", new_life_total);
-    lv_label_set_text(life_label, buf);
-  }
-  if (life_arc != nullptr)
-  {
-    arc_segment_t seg = life_to_arc(new_life_total);
-    uint16_t c16 = lv_color_to_u16(seg.color);
-    uint8_t r = (c16 >> 11) & 0x1F;
-    uint8_t g = (c16 >> 5) & 0x3F;
-    uint8_t b = c16 & 0x1F;
-    r = (r << 3) | (r >> 2);
-    g = (g << 2) | (g >> 4);
-    b = (b << 3) | (b >> 2);
-    lv_arc_set_angles(life_arc, seg.start_angle, seg.end_angle);
-    lv_obj_set_style_arc_color(life_arc, seg.color, LV_PART_INDICATOR);
-  }
+  life_model_set_total(PLAYER_SINGLE, new_life_total);
+}
+
+// Life total subject -> arc
+static void life_arc_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  arc_segment_t seg = life_to_arc(lv_subject_get_int(subject));
+  arc_update(lv_observer_get_target_obj(observer), seg); // redraws only the slice that moved
+}
+
+// Pending change subject -> grouped change label, signed and colored
+static void pending_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  lv_obj_t *label = lv_observer_get_target_obj(observer);
+  int pending_change = lv_subject_get_int(subject);
+  char buf[8];
+  snprintf(buf, sizeof(buf), pending_change > 0 ? "+%d" : "%d", pending_change);
+  lv_obj_set_style_text_color(label, pending_change >= 0 ? GREEN_COLOR : RED_COLOR, 0);
+  lv_label_set_text(label, buf);
 }
 
 // Helper for color interpolation
@@ -448,27 +524,49 @@ void queue_life_change(int player, int value)
     int pending_change = event_grouper.getPendingChange() + value;
     int current_life = event_grouper.getLifeTotal();
     update_life_label((current_life + pending_change));
-    char buf[8];
-    if (pending_change > 0)
-    {
-      snprintf(buf, sizeof(buf), "+%d", pending_change);
-    }
-    else
-    {
-      snprintf(buf, sizeof(buf), "%d", pending_change);
-    }
-    lv_obj_set_style_text_color(grouped_change_label, pending_change >= 0 ? GREEN_COLOR : RED_COLOR, 0);
-    lv_label_set_text(grouped_change_label, buf);
+    life_model_set_pending(PLAYER_SINGLE, pending_change);
 
     // Ensure the label is visible immediately
     lv_obj_clear_flag(grouped_change_label, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_opa(grouped_change_label, LV_OPA_COVER, 0);
-    fade_out_obj(grouped_change_label, 100, GROUPER_WINDOW, [](lv_anim_t *fade_out_anim)
+    // Extends the pending fade instead of stacking one per tap
+    fade_obj(grouped_change_label, ANIM_PROP_TEXT_OPA, LV_OPA_COVER, LV_OPA_TRANSP, 100, GROUPER_WINDOW, [](lv_anim_t *fade_out_anim)
                  {
       // Hide the label after fade-out
       if (fade_out_anim && fade_out_anim->var) {
         lv_obj_add_flag((lv_obj_t *)fade_out_anim->var, LV_OBJ_FLAG_HIDDEN);
-      } });
-    event_grouper.handleChange(player, value, get_elapsed_seconds(), NULL);
+      } }, ANIM_EXTEND);
+    event_grouper.handleChange(player, value, game_clock_seconds(), journal_append);
+  }
+}
+
+// Revert the pending change or the last committed one (swipe up)
+void undo_life_change()
+{
+  if (is_initializing)
+    return;
+  bool was_pending = event_grouper.isCommitPending();
+  if (!event_grouper.undo())
+    return;
+  if (!was_pending)
+    journal_undo(PLAYER_SINGLE);
+  update_life_label(event_grouper.getLifeTotal());
+  life_model_set_pending(PLAYER_SINGLE, 0);
+  if (grouped_change_label != nullptr)
+  {
+    lv_anim_delete(grouped_change_label, NULL);
+    lv_obj_add_flag(grouped_change_label, LV_OBJ_FLAG_HIDDEN);
   }
+  LOG_D(UI, "[undo_life_change] Life %d, undo depth %u, redo depth %u\n", event_grouper.getLifeTotal(),
+         (unsigned)event_grouper.getUndoDepth(), (unsigned)event_grouper.getRedoDepth());
+}
+
+// Re-apply the last undone change (swipe right)
+void redo_life_change()
+{
+  LifeHistoryEvent evt;
+  if (is_initializing || !event_grouper.redo(&evt))
+    return;
+  journal_append(evt);
+  update_life_label(event_grouper.getLifeTotal());
+  LOG_D(UI, "[redo_life_change] Life %d, redo depth %u\n", event_grouper.getLifeTotal(), (unsigned)event_grouper.getRedoDepth());
 }
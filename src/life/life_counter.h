@@ -3,7 +3,13 @@
 #include <helpers/event_grouper.h>
 
 void init_life_counter();
+void prebuild_life_counter();
+void resume_life_counter();
+void suspend_life_counter();
 void reset_life();
+void queue_life_change(int player, int value);
+void undo_life_change();
+void redo_life_change();
 void clear_amp();
 void life_counter_loop();
 void teardown_life_counter();
@@ -10,6 +10,10 @@
 #include <menu/menu.h>
 #include "constants/constants.h"
 #include <timer/timer.h>
+#include <state/life_model.h>
+#include <state/journal.h>
+#include <helpers/arc_update.h>
+#include <theme/theme.h>
 
 // --- Two Player Life Counter GUI State ---
 #define ARC_GAP_DEGREES 60
@@ -26,9 +30,13 @@ static lv_point_precise_t center_line_points[2];
 
 // --- Forward Declarations ---
 void update_life_label(int player, int value);
+static void life_arc_p1_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void life_arc_p2_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
+static void pending_observer_cb(lv_observer_t *observer, lv_subject_t *subject);
 static void arc_sweep_anim_cb_p1(void *var, int32_t value);
 static void arc_sweep_anim_cb_p2(void *var, int32_t value);
 static void arc_sweep_anim_ready_cb(lv_anim_t *a);
+static void register_life_counter_2P_gestures();
 static void life_counter_gesture_event_handler(lv_event_t *e);
 static lv_color_t interpolate_color(lv_color_t c1, lv_color_t c2, uint8_t t);
 void increment_life(int player, int value);
@@ -48,14 +56,9 @@ static lv_obj_t *grouped_change_label_p1 = nullptr;
 static lv_obj_t *grouped_change_label_p2 = nullptr;
 static bool is_initializing_2p = false;
 
-// Call this after boot animation to show the two-player life counter
-void init_life_counter_2P()
+// Create the two-player widgets (hidden/transparent) if they do not exist yet
+static void create_life_counter_2P_widgets()
 {
-  is_initializing_2p = true;  // Set flag to indicate initialization is active
-  teardown_life_counter_2P(); // Clean up any previous state
-  int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
-  event_grouper_p1.resetHistory(max_life);
-  event_grouper_p2.resetHistory(max_life);
   if (!life_counter_container_2p)
   {
     life_counter_container_2p = lv_obj_create(lv_scr_act());
@@ -64,10 +67,7 @@ void init_life_counter_2P()
     lv_obj_clear_flag(life_counter_container_2p, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_clear_flag(life_counter_container_2p, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_set_scrollbar_mode(life_counter_container_2p, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_bg_opa(life_counter_container_2p, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_opa(life_counter_container_2p, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_pad_all(life_counter_container_2p, 0, 0);
-    lv_obj_set_style_border_width(life_counter_container_2p, 0, 0);
+    lv_obj_add_style(life_counter_container_2p, &style_bare_container, 0);
 
     // Set up grid: 3 columns, 1 row
     static lv_coord_t col_dsc[] = {10, LV_GRID_FR(1), 5, LV_GRID_FR(1), 10, LV_GRID_TEMPLATE_LAST};
@@ -85,13 +85,12 @@ void init_life_counter_2P()
     int arc1_bg_end = 270;
     lv_arc_set_bg_angles(life_arc_p1, arc1_bg_start, arc1_bg_end);
     lv_arc_set_angles(life_arc_p1, arc1_bg_start, arc1_bg_start); // Start at min
-    lv_obj_set_style_arc_color(life_arc_p1, GREEN_COLOR, LV_PART_INDICATOR);
-    lv_obj_set_style_arc_opa(life_arc_p1, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(life_arc_p1, 0, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(life_arc_p1, ARC_WIDTH, LV_PART_INDICATOR);
+    lv_obj_add_style(life_arc_p1, &style_life_arc_main, LV_PART_MAIN);
+    lv_obj_add_style(life_arc_p1, &style_life_arc_indicator, LV_PART_INDICATOR);
     // lv_obj_set_style_arc_rounded(life_arc_p1, 0, LV_PART_INDICATOR);
     lv_obj_remove_style(life_arc_p1, NULL, LV_PART_KNOB);
     lv_obj_clear_flag(life_arc_p1, LV_OBJ_FLAG_CLICKABLE);
+    lv_subject_add_observer_obj(life_model_subject_total(PLAYER_ONE), life_arc_p1_observer_cb, life_arc_p1, NULL);
   }
   if (!life_label_p1)
   {
@@ -102,19 +101,20 @@ void init_life_counter_2P()
       lv_obj_set_style_text_font(life_label_p1, &lv_font_montserrat_48, 0);
     else
       lv_obj_set_style_text_font(life_label_p1, &lv_font_montserrat_72, 0);
-    lv_obj_set_style_text_color(life_label_p1, lv_color_white(), 0);
+    lv_obj_add_style(life_label_p1, &style_life_label, 0);
     lv_obj_set_style_text_opa(life_label_p1, LV_OPA_TRANSP, 0);
     // Place in grid: column 0, row 0, center vertically and horizontally
     lv_obj_set_grid_cell(life_label_p1, LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_START, 1, 1);
+    lv_label_bind_text(life_label_p1, life_model_subject_total(PLAYER_ONE), "%d");
   }
   if (!grouped_change_label_p1)
   {
     grouped_change_label_p1 = lv_label_create(life_counter_container_2p);
     lv_obj_add_flag(grouped_change_label_p1, LV_OBJ_FLAG_HIDDEN);
     lv_label_set_text(grouped_change_label_p1, "0");
-    lv_obj_set_style_text_font(grouped_change_label_p1, &lv_font_montserrat_40, 0);
-    lv_obj_set_style_text_color(grouped_change_label_p1, lv_color_white(), 0);
+    lv_obj_add_style(grouped_change_label_p1, &style_change_label, 0);
     lv_obj_set_grid_cell(grouped_change_label_p1, LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_END, 0, 1);
+    lv_subject_add_observer_obj(life_model_subject_pending(PLAYER_ONE), pending_observer_cb, grouped_change_label_p1, NULL);
   }
   if (!life_arc_p2)
   {
@@ -129,13 +129,12 @@ void init_life_counter_2P()
     lv_arc_set_bg_angles(life_arc_p2, arc2_bg_start, arc2_bg_end);
     lv_arc_set_angles(life_arc_p2, arc2_bg_start, arc2_bg_start); // Start at min
     lv_arc_set_mode(life_arc_p2, LV_ARC_MODE_REVERSE);            // Enable reverse mode for counterclockwise sweep
-    lv_obj_set_style_arc_color(life_arc_p2, GREEN_COLOR, LV_PART_INDICATOR);
-    lv_obj_set_style_arc_opa(life_arc_p2, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(life_arc_p2, 0, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(life_arc_p2, ARC_WIDTH, LV_PART_INDICATOR);
+    lv_obj_add_style(life_arc_p2, &style_life_arc_main, LV_PART_MAIN);
+    lv_obj_add_style(life_arc_p2, &style_life_arc_indicator, LV_PART_INDICATOR);
     // lv_obj_set_style_arc_rounded(life_arc_p2, 0, LV_PART_INDICATOR); // Square ends
     lv_obj_remove_style(life_arc_p2, NULL, LV_PART_KNOB);
     lv_obj_clear_flag(life_arc_p2, LV_OBJ_FLAG_CLICKABLE);
+    lv_subject_add_observer_obj(life_model_subject_total(PLAYER_TWO), life_arc_p2_observer_cb, life_arc_p2, NULL);
   }
   if (!life_label_p2)
   {
@@ -146,20 +145,51 @@ void init_life_counter_2P()
       lv_obj_set_style_text_font(life_label_p2, &lv_font_montserrat_48, 0);
     else
       lv_obj_set_style_text_font(life_label_p2, &lv_font_montserrat_72, 0);
-    lv_obj_set_style_text_color(life_label_p2, lv_color_white(), 0);
+    lv_obj_add_style(life_label_p2, &style_life_label, 0);
     lv_obj_set_style_text_opa(life_label_p2, LV_OPA_TRANSP, 0);
     // Place in grid: column 2, row 0, center vertically and horizontally
     lv_obj_set_grid_cell(life_label_p2, LV_GRID_ALIGN_CENTER, 3, 1, LV_GRID_ALIGN_START, 1, 1);
+    lv_label_bind_text(life_label_p2, life_model_subject_total(PLAYER_TWO), "%d");
   }
   if (!grouped_change_label_p2)
   {
     grouped_change_label_p2 = lv_label_create(life_counter_container_2p);
     lv_obj_add_flag(grouped_change_label_p2, LV_OBJ_FLAG_HIDDEN);
     lv_label_set_text(grouped_change_label_p2, "0");
-    lv_obj_set_style_text_font(grouped_change_label_p2, &lv_font_montserrat_40, 0);
-    lv_obj_set_style_text_color(grouped_change_label_p2, lv_color_white(), 0);
+    lv_obj_add_style(grouped_change_label_p2, &style_change_label, 0);
     lv_obj_set_grid_cell(grouped_change_label_p2, LV_GRID_ALIGN_CENTER, 3, 1, LV_GRID_ALIGN_END, 0, 1);
+    lv_subject_add_observer_obj(life_model_subject_pending(PLAYER_TWO), pending_observer_cb, grouped_change_label_p2, NULL);
+  }
+  // Create the center line last so it is drawn on top
+  if (!center_line)
+  {
+    int cont_w = SCREEN_DIAMETER; // Use SCREEN_DIAMETER for full width
+    int cont_h = SCREEN_DIAMETER; // Use SCREEN_DIAMETER for full height
+    int x_center = cont_w / 2;
+    center_line_points[0].x = x_center;
+    center_line_points[0].y = 60;
+    center_line_points[1].x = x_center;
+    center_line_points[1].y = cont_h - 60;
+    center_line = lv_line_create(life_counter_container_2p);
+    lv_line_set_points(center_line, center_line_points, 2);
+    lv_obj_set_style_line_color(center_line, WHITE_COLOR, 0);
+    lv_obj_set_style_line_width(center_line, 1, 0); // Very Thin line
+    lv_obj_set_style_line_opa(center_line, LV_OPA_COVER, 0);
+    lv_obj_set_style_line_rounded(center_line, 1, 0);
   }
+}
+
+// Call this after boot animation to show the two-player life counter
+void init_life_counter_2P()
+{
+  is_initializing_2p = true;  // Set flag to indicate initialization is active
+  teardown_life_counter_2P(); // Clean up any previous state
+  int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
+  event_grouper_p1.resetHistory(max_life);
+  event_grouper_p2.resetHistory(max_life);
+  journal_reset(PLAYER_ONE, max_life);
+  journal_reset(PLAYER_TWO, max_life);
+  create_life_counter_2P_widgets();
 
   if (life_arc_p1)
   {
@@ -169,13 +199,13 @@ void init_life_counter_2P()
     lv_obj_set_style_arc_opa(life_arc_p1, LV_OPA_COVER, LV_PART_INDICATOR);
     lv_anim_t anim1;
     lv_anim_init(&anim1);
-    lv_anim_set_var(&anim1, NULL);
+    lv_anim_set_var(&anim1, life_arc_p1); // keyed on the arc so teardown cancels it
     lv_anim_set_exec_cb(&anim1, arc_sweep_anim_cb_p1);
     lv_anim_set_values(&anim1, 0, max_life);
     lv_anim_set_time(&anim1, 1500);
     lv_anim_set_delay(&anim1, 0);
     lv_anim_set_ready_cb(&anim1, arc_sweep_anim_ready_cb);
-    lv_anim_start(&anim1);
+    anim_start_keyed(&anim1);
   }
 
   if (life_arc_p2)
@@ -185,30 +215,13 @@ void init_life_counter_2P()
     lv_obj_set_style_arc_opa(life_arc_p2, LV_OPA_COVER, LV_PART_INDICATOR);
     lv_anim_t anim2;
     lv_anim_init(&anim2);
-    lv_anim_set_var(&anim2, NULL);
+    lv_anim_set_var(&anim2, life_arc_p2);
     lv_anim_set_exec_cb(&anim2, arc_sweep_anim_cb_p2);
     lv_anim_set_values(&anim2, 0, max_life);
     lv_anim_set_time(&anim2, 1500);
     lv_anim_set_delay(&anim2, 0);
     lv_anim_set_ready_cb(&anim2, arc_sweep_anim_ready_cb);
-    lv_anim_start(&anim2);
-  }
-  // Now create the center line so it is drawn on top
-  if (!center_line)
-  {
-    int cont_w = SCREEN_DIAMETER; // Use SCREEN_DIAMETER for full width
-    int cont_h = SCREEN_DIAMETER; // Use SCREEN_DIAMETER for full height
-    int x_center = cont_w / 2;
-    center_line_points[0].x = x_center;
-    center_line_points[0].y = 60;
-    center_line_points[1].x = x_center;
-    center_line_points[1].y = cont_h - 60;
-    center_line = lv_line_create(life_counter_container_2p);
-    lv_line_set_points(center_line, center_line_points, 2);
-    lv_obj_set_style_line_color(center_line, WHITE_COLOR, 0);
-    lv_obj_set_style_line_width(center_line, 1, 0); // Very Thin line
-    lv_obj_set_style_line_opa(center_line, LV_OPA_COVER, 0);
-    lv_obj_set_style_line_rounded(center_line, 1, 0);
+    anim_start_keyed(&anim2);
   }
   // Fade in the life labels
   lv_obj_clear_flag(life_label_p1, LV_OBJ_FLAG_HIDDEN);
@@ -224,6 +237,54 @@ void init_life_counter_2P()
   }
 }
 
+// Build the view ahead of time so a mode switch only has to unhide it
+void prebuild_life_counter_2P()
+{
+  if (life_counter_container_2p)
+    return;
+  create_life_counter_2P_widgets();
+  lv_obj_add_flag(life_counter_container_2p, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Show the view with its current game state, skipping the boot sweep and fades
+void resume_life_counter_2P()
+{
+  prebuild_life_counter_2P();
+  lv_obj_clear_flag(life_counter_container_2p, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_t *arcs[] = {life_arc_p1, life_arc_p2};
+  for (lv_obj_t *arc : arcs)
+  {
+    lv_obj_clear_flag(arc, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_style_arc_opa(arc, LV_OPA_COVER, LV_PART_INDICATOR);
+  }
+  lv_obj_t *labels[] = {life_label_p1, life_label_p2};
+  for (lv_obj_t *label : labels)
+  {
+    lv_anim_delete(label, NULL);
+    lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_style_text_opa(label, LV_OPA_COVER, 0);
+  }
+  update_life_label(1, event_grouper_p1.getLifeTotal() + event_grouper_p1.getPendingChange());
+  update_life_label(2, event_grouper_p2.getLifeTotal() + event_grouper_p2.getPendingChange());
+
+  // Carry the running timer over from the other view
+  if (player_store.getInt(KEY_SHOW_TIMER, 0))
+  {
+    attach_timer(life_counter_container_2p);
+    lv_obj_set_grid_cell(timer_container, LV_GRID_ALIGN_CENTER, 0, 5, LV_GRID_ALIGN_START, 2, 1);
+  }
+  is_initializing_2p = false;
+  clear_gesture_callbacks();
+  register_life_counter_2P_gestures();
+}
+
+// Hide the view but keep its widgets and game state for the next switch
+void suspend_life_counter_2P()
+{
+  if (life_counter_container_2p)
+    lv_obj_add_flag(life_counter_container_2p, LV_OBJ_FLAG_HIDDEN);
+}
+
 // Increment life total and update label
 void increment_life(int player, step_size_t step_size)
 {
@@ -250,6 +311,7 @@ void teardown_life_counter_2P()
   // Clean up previous objects before creating new ones
   if (life_counter_container_2p)
   {
+    anim_cancel(life_counter_container_2p); // Drop sweeps and fades before their targets go away
     lv_obj_del(life_counter_container_2p);
     life_counter_container_2p = nullptr;
   }
@@ -268,8 +330,12 @@ void reset_life_2p()
 {
   int life_value = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
   event_grouper_p1.resetHistory(life_value);
+  journal_reset(PLAYER_ONE, life_value);
+  life_model_set_pending(PLAYER_ONE, 0);
   update_life_label(1, life_value);
   event_grouper_p2.resetHistory(life_value);
+  journal_reset(PLAYER_TWO, life_value);
+  life_model_set_pending(PLAYER_TWO, 0);
   update_life_label(2, life_value);
 }
 
@@ -279,16 +345,7 @@ static void arc_sweep_anim_cb_p1(void *var, int32_t v)
   int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
   if (v > max_life)
     v = max_life;
-  // Sweep left: 90°+gap/2 to 270° (Player 1)
-  int arc_start = 90 + ARC_GAP_DEGREES / 2;
-  int arc_end = 270;
-  int arc_span = arc_end - arc_start;
-  int sweep = (int)(arc_span * ((float)v / (float)max_life) + 0.5f);
-  int end_angle = arc_start + sweep;
-  if (end_angle > arc_end)
-    end_angle = arc_end;
-  lv_arc_set_angles(life_arc_p1, arc_start, end_angle);
-  update_life_label(1, v);
+  update_life_label(1, v); // The arc follows the label on the next flush
 }
 
 // Animation callback for arc (Player 2)
@@ -297,25 +354,19 @@ static void arc_sweep_anim_cb_p2(void *var, int32_t v)
   int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
   if (v > max_life)
     v = max_life;
-  // For right half: use start_angle=270, end_angle=90-gap/2 (reverse mode, grows counterclockwise)
-  int arc_start = 270;
-  int arc_end = 90 - ARC_GAP_DEGREES / 2;
-  int arc_span = (arc_end - arc_start + 360) % 360;
-  int sweep = (int)(arc_span * ((float)v / (float)max_life) + 0.5f);
-  if (arc_span == 0)
-    arc_span = 360; // fallback
-  if (sweep > arc_span)
-    sweep = arc_span;
-  int anim_end = (arc_end - sweep + 360) % 360;
-  lv_arc_set_angles(life_arc_p2, anim_end, arc_end);
-  update_life_label(2, v);
+  update_life_label(2, v); // The arc follows the label on the next flush
 }
 
 // Animation ready callback (optional, can be NULL)
 static void arc_sweep_anim_ready_cb(lv_anim_t *a)
 {
   is_initializing_2p = false;
-  // Register gesture callbacks for tap and swipe, consistent with 1P mode
+  register_life_counter_2P_gestures();
+}
+
+// Register gesture callbacks for tap and swipe, consistent with 1P mode
+static void register_life_counter_2P_gestures()
+{
   register_gesture_callback(GestureType::TapTopLeft, []()
                             { increment_life(PLAYER_ONE, step_size_t::STEP_SIZE_SMALL); });
   register_gesture_callback(GestureType::TapBottomLeft, []()
@@ -413,25 +464,32 @@ static arc_segment_t life_to_arc_p2(int life_total)
   return seg;
 }
 
-// Update the life label and arc for Player 1
+// Record the displayed life total; the label and arc follow on the next flush
 void update_life_label(int player, int new_life_total)
 {
-  lv_obj_t *life_label = (player == 1) ? life_label_p1 : life_label_p2;
-  lv_obj_t *life_arc = (player == 1) ? life_arc_p1 : life_arc_p2;
+  life_model_set_total(player, new_life_total);
+}
 
-  if (life_label != nullptr)
-  {
-    char buf[8];
-    snprintf(buf, sizeof(buf), "%d", new_life_total);
-    lv_label_set_text(life_label, buf);
-  }
+// Life total subjects -> arcs
+static void life_arc_p1_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  arc_update(lv_observer_get_target_obj(observer), life_to_arc_p1(lv_subject_get_int(subject))); // only the moved slice
+}
 
-  if (life_arc != nullptr)
-  {
-    arc_segment_t seg = (player == 1) ? life_to_arc_p1(new_life_total) : life_to_arc_p2(new_life_total);
-    lv_arc_set_angles(life_arc, seg.start_angle, seg.end_angle);
-    lv_obj_set_style_arc_color(life_arc, seg.color, LV_PART_INDICATOR);
-  }
+static void life_arc_p2_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  arc_update(lv_observer_get_target_obj(observer), life_to_arc_p2(lv_subject_get_int(subject)));
+}
+
+// Pending change subject -> grouped change label, signed and colored
+static void pending_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  lv_obj_t *label = lv_observer_get_target_obj(observer);
+  int pending_change = lv_subject_get_int(subject);
+  char buf[8];
+  snprintf(buf, sizeof(buf), pending_change > 0 ? "+%d" : "%d", pending_change);
+  lv_obj_set_style_text_color(label, pending_change >= 0 ? GREEN_COLOR : RED_COLOR, 0);
+  lv_label_set_text(label, buf);
 }
 
 // Helper for color interpolation
@@ -479,28 +537,15 @@ void queue_life_change_2p(int player, int value)
     // Show the pending change BEFORE the grouper updates its state
     int pending_change = grouper->getPendingChange() + value;
     int current_life = grouper->getLifeTotal();
-    if (player == 1)
-      update_life_label(1, (current_life + pending_change));
-    else
-      update_life_label(2, (current_life + pending_change));
-    char buf[8];
-    if (pending_change > 0)
-    {
-      snprintf(buf, sizeof(buf), "+%d", pending_change);
-    }
-    else
-    {
-      snprintf(buf, sizeof(buf), "%d", pending_change);
-    }
-    lv_obj_set_style_text_color(grouped_change_label, pending_change >= 0 ? GREEN_COLOR : RED_COLOR, 0);
-    lv_label_set_text(grouped_change_label, buf);
+    update_life_label(player, (current_life + pending_change));
+    life_model_set_pending(player, pending_change);
     lv_obj_clear_flag(grouped_change_label, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_style_text_opa(grouped_change_label, LV_OPA_COVER, 0);
-    fade_out_obj(grouped_change_label, 100, GROUPER_WINDOW, [](lv_anim_t *fade_out_anim)
+    // Extends the pending fade instead of stacking one per tap
+    fade_obj(grouped_change_label, ANIM_PROP_TEXT_OPA, LV_OPA_COVER, LV_OPA_TRANSP, 100, GROUPER_WINDOW, [](lv_anim_t *fade_out_anim)
                  {
       if (fade_out_anim && fade_out_anim->var) {
         lv_obj_add_flag((lv_obj_t *)fade_out_anim->var, LV_OBJ_FLAG_HIDDEN);
-      } });
+      } }, ANIM_EXTEND);
   }
-  grouper->handleChange(player, value, get_elapsed_seconds(), NULL);
+  grouper->handleChange(player, value, game_clock_seconds(), journal_append);
 }
\ No newline at end of file
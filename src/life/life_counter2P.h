@@ -3,7 +3,11 @@
 #include <helpers/event_grouper.h>
 
 void init_life_counter_2P();
+void prebuild_life_counter_2P();
+void resume_life_counter_2P();
+void suspend_life_counter_2P();
 void reset_life_2p();
+void queue_life_change_2p(int player, int value);
 void life_counter2p_loop();
 void teardown_life_counter_2P();
 
@@ -0,0 +1,140 @@
+#include "log.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <atomic>
+
+static_assert((LOG_SLOTS & (LOG_SLOTS - 1)) == 0, "LOG_SLOTS must be a power of two");
+
+// Multi-producer, single-consumer ring of fixed slots. A producer claims a
+// slot by moving head forward with a CAS (or drops the message if the ring is
+// full), formats into it and then marks it ready. The consumer releases slots
+// in order, so a slot is only reused once its line has been written out.
+struct LogSlot
+{
+  std::atomic<uint8_t> ready;
+  uint8_t level;
+  char text[LOG_LINE_MAX];
+};
+
+static LogSlot slots[LOG_SLOTS];
+static std::atomic<uint32_t> head{0};
+static std::atomic<uint32_t> tail{0};
+static std::atomic<uint32_t> dropped{0};       // not reported yet
+static std::atomic<uint32_t> dropped_total{0}; // since boot
+static std::atomic<bool> draining{false}; // one consumer at a time: the task or log_flush
+static bool task_started = false;
+static TaskHandle_t log_task_handle = nullptr;
+
+static void write_line(uint8_t level, const char *text)
+{
+  // Errors and warnings get a tag, the rest keep the usual "[func] msg" look
+  if (level == LOG_LVL_ERROR || level == LOG_LVL_WARN)
+    printf("%c %s", level == LOG_LVL_ERROR ? 'E' : 'W', text);
+  else
+    fputs(text, stdout);
+}
+
+// Format into a line buffer, keeping the newline when the text is cut short
+static void format_line(char *text, const char *fmt, va_list args)
+{
+  int len = vsnprintf(text, LOG_LINE_MAX, fmt, args);
+  if (len >= LOG_LINE_MAX)
+    text[LOG_LINE_MAX - 2] = '\n';
+}
+
+static void drain()
+{
+  bool expected = false;
+  if (!draining.compare_exchange_strong(expected, true, std::memory_order_acquire))
+    return;
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    LogSlot &slot = slots[t & (LOG_SLOTS - 1)];
+    if (!slot.ready.load(std::memory_order_acquire))
+      break;
+    write_line(slot.level, slot.text);
+    slot.ready.store(0, std::memory_order_relaxed);
+    tail.store(++t, std::memory_order_release);
+  }
+  uint32_t lost = dropped.exchange(0, std::memory_order_relaxed);
+  if (lost)
+    printf("W [log] %u messages dropped, ring full\n", (unsigned)lost);
+  fflush(stdout);
+  draining.store(false, std::memory_order_release);
+}
+
+// Sleeps until log_write hands it a line. A drain skipped because log_flush
+// held the ring is fine: log_flush empties it itself.
+static void log_task(void *pvParameters)
+{
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    drain();
+  }
+}
+
+void log_init(void)
+{
+  if (task_started)
+    return;
+  xTaskCreatePinnedToCore(log_task, "log_task", 3072, NULL, tskIDLE_PRIORITY + 1, &log_task_handle, LOG_TASK_CORE);
+  task_started = true; // only now is there a handle to notify
+}
+
+void log_write(uint8_t level, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  if (!task_started)
+  {
+    // Early boot: nothing to drain the ring yet
+    char text[LOG_LINE_MAX];
+    format_line(text, fmt, args);
+    va_end(args);
+    write_line(level, text);
+    return;
+  }
+
+  uint32_t h = head.load(std::memory_order_relaxed);
+  do
+  {
+    if (h - tail.load(std::memory_order_acquire) >= LOG_SLOTS)
+    {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      dropped_total.fetch_add(1, std::memory_order_relaxed);
+      va_end(args);
+      xTaskNotifyGive(log_task_handle);
+      return;
+    }
+  } while (!head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  LogSlot &slot = slots[h & (LOG_SLOTS - 1)];
+  slot.level = level;
+  format_line(slot.text, fmt, args);
+  va_end(args);
+  slot.ready.store(1, std::memory_order_release);
+  xTaskNotifyGive(log_task_handle);
+}
+
+void log_flush(void)
+{
+  if (!task_started)
+    return;
+  // The drain task may hold the ring or a writer may be mid-format: retry a
+  // few ticks, but never hang a shutdown on the log
+  for (int attempt = 0; attempt < 10; ++attempt)
+  {
+    drain();
+    if (tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire))
+      return;
+    vTaskDelay(1);
+  }
+}
+
+uint32_t log_dropped(void)
+{
+  return dropped_total.load(std::memory_order_relaxed);
+}
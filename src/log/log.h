@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+
+// Leveled logging that stays off the render path. Levels are resolved per
+// module at compile time: a call above its module's level is a constant-false
+// branch and compiles away along with its arguments. Enabled messages are
+// formatted into a lock-free ring and written to the UART by a low priority
+// task on core 0, woken by each message so it sleeps while nothing is logged;
+// when the ring is full the message is dropped and counted.
+//
+//   LOG_I(POWER, "[fall_asleep] Shutting down\n");
+//
+// Build flags: -DLOG_LVL_DEFAULT=4 raises every module, -DLOG_LVL_POWER=5 just one.
+
+#define LOG_LVL_NONE 0
+#define LOG_LVL_ERROR 1
+#define LOG_LVL_WARN 2
+#define LOG_LVL_INFO 3
+#define LOG_LVL_DEBUG 4
+#define LOG_LVL_VERBOSE 5
+
+#ifndef LOG_LVL_DEFAULT
+#define LOG_LVL_DEFAULT LOG_LVL_INFO
+#endif
+
+// Modules
+#ifndef LOG_LVL_MAIN // setup, GUI task, panel sleep
+#define LOG_LVL_MAIN LOG_LVL_DEFAULT
+#endif
+#ifndef LOG_LVL_UI // screens, menus, life counters
+#define LOG_LVL_UI LOG_LVL_DEFAULT
+#endif
+#ifndef LOG_LVL_DISPLAY // refresh rate, backlight
+#define LOG_LVL_DISPLAY LOG_LVL_DEFAULT
+#endif
+#ifndef LOG_LVL_POWER
+#define LOG_LVL_POWER LOG_LVL_DEFAULT
+#endif
+#ifndef LOG_LVL_BATTERY
+#define LOG_LVL_BATTERY LOG_LVL_DEFAULT
+#endif
+#ifndef LOG_LVL_STATE // journal, RTC snapshot
+#define LOG_LVL_STATE LOG_LVL_DEFAULT
+#endif
+#ifndef LOG_LVL_MEM
+#define LOG_LVL_MEM LOG_LVL_DEFAULT
+#endif
+
+#define LOG_LINE_MAX 128 // longer messages are truncated
+#define LOG_SLOTS 64     // power of two
+#define LOG_TASK_CORE 0
+
+#define LOG_AT(module, level, fmt, ...)                 \
+  do                                                    \
+  {                                                     \
+    if ((level) <= LOG_LVL_##module)                    \
+      log_write((level), fmt, ##__VA_ARGS__);           \
+  } while (0)
+
+#define LOG_E(module, fmt, ...) LOG_AT(module, LOG_LVL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_W(module, fmt, ...) LOG_AT(module, LOG_LVL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_I(module, fmt, ...) LOG_AT(module, LOG_LVL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_D(module, fmt, ...) LOG_AT(module, LOG_LVL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_V(module, fmt, ...) LOG_AT(module, LOG_LVL_VERBOSE, fmt, ##__VA_ARGS__)
+
+// Starts the drain task. Messages logged before this are written directly.
+void log_init(void);
+// Queue one message, from any task (not from an ISR)
+void log_write(uint8_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+// Write out everything queued now, e.g. right before deep sleep or a restart
+void log_flush(void);
+uint32_t log_dropped(void); // since boot
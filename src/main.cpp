@@ -4,7 +4,12 @@
 #include "gui_main.h"
 #include <esp_display_panel.hpp>
 #include <esp_sleep.h>
+#include <esp_timer.h>
+#include <esp_lcd_panel_ops.h>
 #include "power_key/power_key.h"
+#include "power_key/power_pm.h"
+#include "helpers/refresh_rate.h"
+#include "ambient/ambient.h"
 #include "constants/constants.h"
 #include "battery/battery_state.h"
 #include <life/life_counter.h>
@@ -12,6 +17,19 @@
 #include <helpers/event_grouper.h>
 #include "main.h"
 #include "state/state_store.h"
+#include "state/life_model.h"
+#include "state/journal.h"
+#include "helpers/game_clock.h"
+#include "replay/replay.h"
+#include "touch/touch_capture.h"
+#include "render_check/render_check.h"
+#include "memory/mem_policy.h"
+#include "helpers/backlight.h"
+#include "theme/theme.h"
+#include <esp_heap_caps.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include "log/log.h"
 
 using namespace esp_panel::drivers;
 using namespace esp_panel::board;
@@ -36,6 +54,8 @@ BaseType_t create_task(TaskFunction_t task_function, const char *task_name, uint
 
 /* Forward declaration for flush_cb */
 void flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map);
+static void display_sleep();
+static void display_wake();
 
 /* Forward declaration for gui_task */
 void gui_task(void *pvParameters);
@@ -43,26 +63,49 @@ void gui_task(void *pvParameters);
 // Global mode variable (should be updated by UI logic)
 PlayerMode life_counter_mode = PLAYER_MODE_ONE_PLAYER;
 
+// loop_task_call: one call in flight at a time. Whoever clears loop_call_fn owns
+// the call: the loop task by taking it to run, the caller by withdrawing it.
+static TaskHandle_t loop_task_handle = nullptr;
+static std::atomic<void (*)(void)> loop_call_fn{nullptr};
+static SemaphoreHandle_t loop_call_done = nullptr;
+
 void setup()
 {
   Serial.begin(115200);
-  Serial.println("[setup] Serial initialized");
+  log_init();
+  loop_task_handle = xTaskGetCurrentTaskHandle();
+  loop_call_done = xSemaphoreCreateBinary();
+  LOG_I(MAIN, "[setup] Serial initialized\n");
 
   pinMode(PWR_KEY_Input_PIN, INPUT);
   pinMode(PWR_Control_PIN, OUTPUT);
-  Serial.println("[setup] Initializing board");
+  LOG_I(MAIN, "[setup] Initializing board\n");
   board->init();
   assert(board->begin());
   board->getBacklight()->off();
+  pm_init();
+  backlight_init(); // after pm_init, it may need a PM lock
   battery_init();
+  journal_init();
   create_task(gui_task, "gui_task", 16384, NULL, 1, NULL);
   power_init();
 }
 
 void loop()
 {
-  vTaskDelay(10 / portTICK_PERIOD_MS);
-  power_loop();
+  // Only poll quickly while a grouped change is waiting to commit, so an idle
+  // game lets the CPU drop into light sleep
+  bool commit_pending = event_grouper.isCommitPending() || event_grouper_p1.isCommitPending() || event_grouper_p2.isCommitPending();
+  ulTaskNotifyTake(pdTRUE, (commit_pending ? LOOP_ACTIVE_PERIOD_MS : LOOP_IDLE_PERIOD_MS) / portTICK_PERIOD_MS);
+  void (*call_fn)(void) = loop_call_fn.exchange(nullptr);
+  if (call_fn)
+  {
+    call_fn();
+    xSemaphoreGive(loop_call_done);
+  }
+  // A replay drives the groupers itself on its virtual clock
+  if (game_clock_is_virtual())
+    return;
   if (life_counter_mode == PLAYER_MODE_ONE_PLAYER) // Single player mode
   {
     life_counter_loop();
@@ -73,6 +116,26 @@ void loop()
   }
 }
 
+bool loop_task_call(void (*fn)(void))
+{
+  if (!loop_task_handle || xTaskGetCurrentTaskHandle() == loop_task_handle)
+  {
+    fn();
+    return true;
+  }
+  loop_call_fn = fn;
+  xTaskNotifyGive(loop_task_handle); // cut the loop's wait short
+  if (xSemaphoreTake(loop_call_done, LOOP_CALL_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+    return true;
+  // Withdraw the call unless the loop task already took it; once it runs, wait
+  // it out so fn never runs twice at the same time
+  void (*expected)(void) = fn;
+  if (loop_call_fn.compare_exchange_strong(expected, nullptr))
+    return false;
+  xSemaphoreTake(loop_call_done, portMAX_DELAY);
+  return true;
+}
+
 BaseType_t create_task(TaskFunction_t task_function, const char *task_name, uint32_t stack_size, void *param, UBaseType_t priority, TaskHandle_t *task_handle)
 {
   return xTaskCreatePinnedToCore(
@@ -89,25 +152,25 @@ BaseType_t create_task(TaskFunction_t task_function, const char *task_name, uint
 void gui_task(void *pvParameters)
 {
   // Wait for device to be powered on
-  Serial.println("[gui_task] Waiting for device to boot...");
+  LOG_I(MAIN, "[gui_task] Waiting for device to boot...\n");
   while (get_battery_state() != BAT_ON)
   {
     vTaskDelay(100 / portTICK_PERIOD_MS);
   }
 
-  Serial.println("[gui_task] Initializing LVGL");
+  LOG_I(MAIN, "[gui_task] Initializing LVGL\n");
   lv_init();
   lv_tick_set_cb(xTaskGetTickCount);
 
   // Step 1: Create display object (LVGL 9.3)
   lv_display_t *display = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
 
-  // Step 2: Allocate display buffers
-  uint32_t *buf1 = (uint32_t *)malloc(BUFFER_SIZE / 2 * sizeof(uint32_t));
-  uint32_t *buf2 = (uint32_t *)malloc(BUFFER_SIZE / 2 * sizeof(uint32_t));
+  // Step 2: Allocate display buffers, internal and DMA capable since every frame goes through them
+  uint8_t *buf1 = (uint8_t *)heap_caps_malloc(BUFFER_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  uint8_t *buf2 = (uint8_t *)heap_caps_malloc(BUFFER_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
   if (!buf1 || !buf2)
   {
-    Serial.println("[LVGL] ERROR: Display buffer allocation failed!");
+    LOG_E(MAIN, "[gui_task] Display buffer allocation failed!\n");
     while (1)
     {
       vTaskDelay(20 / portTICK_PERIOD_MS);
@@ -122,35 +185,127 @@ void gui_task(void *pvParameters)
   lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), LV_PART_MAIN);
   lv_obj_set_style_bg_opa(lv_scr_act(), LV_OPA_COVER, LV_PART_MAIN);
 
-  Serial.println("[gui_task] Creating UI");
+  LOG_I(MAIN, "[gui_task] Creating UI\n");
+
+  theme_init(); // shared styles, before any widget is built
 
   // Initialize touch first so we have the indev reference
   global_indev = init_touch();
+  life_model_init(); // After the display so its flush runs ahead of rendering
+  battery_subject_start();
+  refresh_rate_init(display, global_indev, xTaskGetCurrentTaskHandle());
+  ambient_init(display);
   ui_init(global_indev);
+  mem_policy_monitor_start();
+#if REPLAY_BENCH_MINUTES
+  lv_timer_t *bench_timer = lv_timer_create([](lv_timer_t *timer)
+                                            { replay_run(replay_generate_game(REPLAY_BENCH_MINUTES, 1, life_counter_mode)); }, REPLAY_BENCH_DELAY_MS, NULL);
+  lv_timer_set_repeat_count(bench_timer, 1);
+#endif
+#if MEM_SLAB_BENCH_CYCLES
+  lv_timer_t *slab_timer = lv_timer_create([](lv_timer_t *timer)
+                                           { mem_slab_benchmark(MEM_SLAB_BENCH_CYCLES); }, MEM_SLAB_BENCH_DELAY_MS, NULL);
+  lv_timer_set_repeat_count(slab_timer, 1);
+#endif
+#if THEME_BENCH_OBJECTS
+  lv_timer_t *theme_timer = lv_timer_create([](lv_timer_t *timer)
+                                            { theme_benchmark(THEME_BENCH_OBJECTS); }, THEME_BENCH_DELAY_MS, NULL);
+  lv_timer_set_repeat_count(theme_timer, 1);
+#endif
+#if JOURNAL_BENCH
+  lv_timer_t *journal_timer = lv_timer_create([](lv_timer_t *timer)
+                                              { journal_benchmark(); }, JOURNAL_BENCH_DELAY_MS, NULL);
+  lv_timer_set_repeat_count(journal_timer, 1);
+#endif
+#if RENDER_CHECK
+  lv_timer_t *check_timer = lv_timer_create([](lv_timer_t *timer)
+                                            { render_check_run(); }, RENDER_CHECK_DELAY_MS, NULL);
+  lv_timer_set_repeat_count(check_timer, 1);
+#endif
 
   // Render black screen first to eliminate static flash
   lv_refr_now(display);
   vTaskDelay(100 / portTICK_PERIOD_MS); // Wait for display to fully update
 
-  // Now turn on backlight with clean black screen showing
-  board->getBacklight()->on();
-  board->getBacklight()->setBrightness(player_store.getInt(KEY_BRIGHTNESS, 100));
+  // First frame is on the panel: fade the backlight up over it (or run the splash)
+  ui_reveal();
 
   // Main GUI loop (LVGL 9.3)
+  bool display_awake = true;
   while (1)
   {
     uint32_t time_till_next = 5;
 
+    // Screen off (standby or USB idle): sleep the panel and stop running LVGL
+    if (!power_display_wanted())
+    {
+      if (display_awake)
+        display_sleep();
+      display_awake = false;
+      journal_erase_ahead();
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+    if (!display_awake)
+    {
+      display_wake();
+      display_awake = true;
+    }
+
     // Timer handler needs to be called periodically to handle the tasks of LVGL
+    pm_lock(PM_LOCK_RENDER);
     time_till_next = lv_timer_handler();
+    pm_unlock(PM_LOCK_RENDER);
 
-    if (time_till_next != LV_NO_TIMER_READY)           // Handle LV_NO_TIMER_READY (-1)
-      vTaskDelay(time_till_next / portTICK_PERIOD_MS); // Delay to avoid unnecessary polling
+    // Nothing to draw for a while: the moment for the journal's next flash erase
+    if (refresh_rate_is_idle())
+      journal_erase_ahead();
+    // With the UI idle most timers are paused, so this can be a long wait;
+    // the touch interrupt cuts it short
+    if (time_till_next == LV_NO_TIMER_READY || time_till_next > REFRESH_MAX_SLEEP_MS) // Handle LV_NO_TIMER_READY (-1)
+      time_till_next = REFRESH_MAX_SLEEP_MS;
+    // Always-on view drawn: nothing on screen changes until a touch or the power
+    // key, so let the CPU light-sleep until one of them notifies
+    if (ambient_is_active() && refresh_rate_is_idle())
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    else
+      ulTaskNotifyTake(pdTRUE, time_till_next / portTICK_PERIOD_MS);
+    refresh_rate_poll();
+    ambient_poll();
+#if TOUCH_CAPTURE
+    touch_capture_poll_serial();
+#endif
   }
 }
 
+// Fade to black, then panel sleep-in; GRAM keeps the last frame
+static void display_sleep()
+{
+  backlight_fade_out(BACKLIGHT_SLEEP_FADE_MS, true);
+  esp_lcd_panel_handle_t panel = board->getLCD()->getRefreshPanelHandle();
+  esp_err_t err = panel ? esp_lcd_panel_disp_sleep(panel, true) : ESP_ERR_INVALID_STATE;
+  LOG_D(MAIN, "[display_sleep] Panel sleep-in: %s\n", esp_err_to_name(err));
+}
+
+// Panel sleep-out, then fade the backlight up over the retained frame
+static void display_wake()
+{
+  esp_lcd_panel_handle_t panel = board->getLCD()->getRefreshPanelHandle();
+  if (panel)
+    esp_lcd_panel_disp_sleep(panel, false);
+  backlight_fade_in(BACKLIGHT_WAKE_FADE_MS);
+  // Time asleep is not inactivity, don't drop straight into the always-on view
+  lv_display_trigger_activity(NULL);
+  int64_t wake_us = power_last_wake_us();
+  if (wake_us)
+    LOG_D(MAIN, "[display_wake] Wake latency: %lldus\n", (long long)(esp_timer_get_time() - wake_us));
+}
+
 void flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map)
 {
+#if RENDER_CHECK
+  render_check_flush(area, px_map);
+#endif
   lv_draw_sw_rgb565_swap(
       px_map, (area->x2 - area->x1 + 1) * (area->y2 - area->y1 + 1));
 
@@ -160,6 +315,8 @@ void flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *px_map)
   const int offsety2 = area->y2;
   int width = offsetx2 - offsetx1 + 1;
   int height = offsety2 - offsety1 + 1;
+  pm_lock(PM_LOCK_FLUSH);
   board->getLCD()->drawBitmap(offsetx1, offsety1, width, height, px_map);
+  pm_unlock(PM_LOCK_FLUSH);
   lv_display_flush_ready(display);
 }
\ No newline at end of file
@@ -7,8 +7,17 @@
 // Enum for life counter mode (if needed, add here)
 // enum LifeCounterMode { ... } // Uncomment and define if you use an enum
 
+#define LOOP_ACTIVE_PERIOD_MS 10 // while a grouped life change waits to commit
+#define LOOP_IDLE_PERIOD_MS 100  // otherwise
+#define LOOP_CALL_TIMEOUT_MS 500
+
 extern PlayerMode life_counter_mode;
 
+// Runs fn on the loop task, which owns the groupers' commit loop, and waits for
+// it; false if the loop task did not pick it up in time, in which case fn has
+// not run. For other tasks that must touch the groupers.
+bool loop_task_call(void (*fn)(void));
+
 BaseType_t create_task(TaskFunction_t task_function, const char *task_name, uint32_t stack_size, void *param, UBaseType_t priority, TaskHandle_t *task_handle = NULL);
 
 #endif // MAIN_H
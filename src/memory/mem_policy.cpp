@@ -0,0 +1,283 @@
+#include "mem_policy.h"
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+#include <esp_memory_utils.h>
+#include <esp_cpu.h>
+#include <stdio.h>
+#include "memory/slab.h"
+#include "menu/menu.h"
+#include "log/log.h"
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+static const uint32_t region_caps[MEM_REGION_COUNT] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT};
+static const char *const region_names[MEM_REGION_COUNT] = {"internal", "psram"};
+
+// Only touched from the GUI task, like the rest of LVGL
+static size_t live_bytes[MEM_REGION_COUNT];
+static size_t peak_bytes[MEM_REGION_COUNT];
+static uint32_t live_blocks[MEM_REGION_COUNT];
+static uint32_t failures[MEM_REGION_COUNT];
+static bool warned = false;
+
+// Allocator cost, only sampled while a benchmark runs
+static bool timing = false;
+static uint64_t alloc_cycles = 0;
+static uint64_t free_cycles = 0;
+static uint32_t alloc_calls = 0;
+static uint32_t free_calls = 0;
+
+static MemRegion region_of(const void *p)
+{
+  return esp_ptr_external_ram(p) ? MEM_REGION_PSRAM : MEM_REGION_INTERNAL;
+}
+
+static void account_alloc(void *p)
+{
+  MemRegion region = region_of(p);
+  live_bytes[region] += heap_caps_get_allocated_size(p);
+  live_blocks[region]++;
+  if (live_bytes[region] > peak_bytes[region])
+    peak_bytes[region] = live_bytes[region];
+}
+
+static void account_free(void *p)
+{
+  MemRegion region = region_of(p);
+  live_bytes[region] -= heap_caps_get_allocated_size(p);
+  live_blocks[region]--;
+}
+
+static bool has_psram()
+{
+  static int present = -1;
+  if (present < 0)
+    present = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+  return present;
+}
+
+// Preferred region first, the other one as a fallback
+static void *alloc_placed(size_t size)
+{
+  if (!has_psram())
+  {
+    void *p = heap_caps_malloc(size, region_caps[MEM_REGION_INTERNAL]);
+    if (!p)
+      failures[MEM_REGION_INTERNAL]++;
+    return p;
+  }
+  MemRegion first = size > MEM_INTERNAL_MAX_BYTES ? MEM_REGION_PSRAM : MEM_REGION_INTERNAL;
+  MemRegion second = first == MEM_REGION_PSRAM ? MEM_REGION_INTERNAL : MEM_REGION_PSRAM;
+  void *p = heap_caps_malloc(size, region_caps[first]);
+  if (!p)
+  {
+    failures[first]++;
+    p = heap_caps_malloc(size, region_caps[second]);
+    if (!p)
+      failures[second]++;
+  }
+  return p;
+}
+
+// --- LVGL stdlib hooks ---
+extern "C"
+{
+  void lv_mem_init(void)
+  {
+    slab_init();
+  }
+
+  void lv_mem_deinit(void)
+  {
+  }
+
+  lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+  {
+    return NULL;
+  }
+
+  void lv_mem_remove_pool(lv_mem_pool_t pool)
+  {
+  }
+
+  void *lv_malloc_core(size_t size)
+  {
+    uint32_t start = timing ? esp_cpu_get_cycle_count() : 0;
+    void *p = slab_alloc(size);
+    if (!p)
+    {
+      p = alloc_placed(size);
+      if (p)
+        account_alloc(p);
+    }
+    if (timing)
+    {
+      alloc_cycles += esp_cpu_get_cycle_count() - start;
+      alloc_calls++;
+    }
+    return p;
+  }
+
+  void *lv_realloc_core(void *p, size_t new_size)
+  {
+    if (!p)
+      return lv_malloc_core(new_size);
+    if (slab_owns(p))
+    {
+      size_t block_size = slab_block_size(p);
+      if (new_size <= block_size)
+        return p;
+      void *grown = lv_malloc_core(new_size);
+      if (grown)
+      {
+        lv_memcpy(grown, p, block_size);
+        lv_free_core(p);
+      }
+      return grown;
+    }
+    // Move when the block changes size class, e.g. a table growing past the limit
+    bool want_psram = new_size > MEM_INTERNAL_MAX_BYTES && has_psram();
+    if (want_psram == (region_of(p) == MEM_REGION_PSRAM))
+    {
+      account_free(p);
+      void *grown = heap_caps_realloc(p, new_size, region_caps[region_of(p)]);
+      account_alloc(grown ? grown : p);
+      return grown;
+    }
+    void *moved = lv_malloc_core(new_size);
+    if (!moved)
+      return NULL;
+    size_t old_size = heap_caps_get_allocated_size(p);
+    lv_memcpy(moved, p, old_size < new_size ? old_size : new_size);
+    lv_free_core(p);
+    return moved;
+  }
+
+  void lv_free_core(void *p)
+  {
+    if (!p)
+      return;
+    uint32_t start = timing ? esp_cpu_get_cycle_count() : 0;
+    if (slab_owns(p))
+    {
+      slab_free(p);
+    }
+    else
+    {
+      account_free(p);
+      heap_caps_free(p);
+    }
+    if (timing)
+    {
+      free_cycles += esp_cpu_get_cycle_count() - start;
+      free_calls++;
+    }
+  }
+
+  void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+  {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, region_caps[MEM_REGION_INTERNAL]);
+    // total - free stays "bytes LVGL holds", so callers measuring deltas keep working
+    size_t live = live_bytes[MEM_REGION_INTERNAL] + live_bytes[MEM_REGION_PSRAM] + slab_live_bytes();
+    mon_p->total_size = live + info.total_free_bytes;
+    mon_p->free_cnt = info.free_blocks;
+    mon_p->free_size = info.total_free_bytes;
+    mon_p->free_biggest_size = info.largest_free_block;
+    mon_p->used_cnt = live_blocks[MEM_REGION_INTERNAL] + live_blocks[MEM_REGION_PSRAM];
+    mon_p->max_used = peak_bytes[MEM_REGION_INTERNAL] + peak_bytes[MEM_REGION_PSRAM];
+    mon_p->used_pct = mon_p->total_size ? (100 * live) / mon_p->total_size : 0;
+    mon_p->frag_pct = info.total_free_bytes ? 100 - (100 * info.largest_free_block) / info.total_free_bytes : 0;
+  }
+
+  lv_result_t lv_mem_test_core(void)
+  {
+    return heap_caps_check_integrity_all(true) ? LV_RESULT_OK : LV_RESULT_INVALID;
+  }
+}
+
+void mem_policy_stats(MemRegion region, MemRegionStats &stats)
+{
+  stats.live = live_bytes[region];
+  stats.peak = peak_bytes[region];
+  stats.blocks = live_blocks[region];
+  stats.failures = failures[region];
+  stats.free = heap_caps_get_free_size(region_caps[region]);
+  stats.min_free = heap_caps_get_minimum_free_size(region_caps[region]);
+  stats.largest_free = heap_caps_get_largest_free_block(region_caps[region]);
+}
+
+void mem_policy_report(void)
+{
+  static const size_t warn_block[MEM_REGION_COUNT] = {MEM_WARN_INTERNAL_BLOCK, MEM_WARN_PSRAM_BLOCK};
+  bool low = false;
+  for (int r = 0; r < MEM_REGION_COUNT; ++r)
+  {
+    MemRegionStats stats;
+    mem_policy_stats((MemRegion)r, stats);
+    if (stats.free == 0)
+      continue; // no PSRAM on this board
+    unsigned frag = 100 - (unsigned)((100 * (uint64_t)stats.largest_free) / stats.free);
+    // Two lines, each within LOG_LINE_MAX
+    LOG_D(MEM, "[mem_policy_report] %-8s lvgl %u B in %u blocks (peak %u B, %u failed)\n",
+          region_names[r], (unsigned)stats.live, (unsigned)stats.blocks, (unsigned)stats.peak, (unsigned)stats.failures);
+    LOG_D(MEM, "[mem_policy_report] %-8s heap free %u B (min %u B), largest block %u B, frag %u%%\n",
+          region_names[r], (unsigned)stats.free, (unsigned)stats.min_free, (unsigned)stats.largest_free, frag);
+    if (stats.largest_free < warn_block[r] || frag > MEM_WARN_FRAG_PCT)
+    {
+      low = true;
+      if (!warned)
+        LOG_W(MEM, "[mem_policy_report] %s heap is fragmenting, largest free block %u B\n", region_names[r], (unsigned)stats.largest_free);
+    }
+  }
+  // Warn once per episode, not on every report
+  warned = low;
+  slab_report();
+}
+
+// Menu churn with the slabs off, then on: allocator cost and what is left of
+// the internal heap afterwards
+void mem_slab_benchmark(uint32_t cycles)
+{
+  bool was_enabled = slab_is_enabled();
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    bool use_slab = pass == 1;
+    slab_set_enabled(use_slab);
+    alloc_cycles = free_cycles = 0;
+    alloc_calls = free_calls = 0;
+    timing = true;
+    uint32_t start_ms = lv_tick_get();
+    for (uint32_t i = 0; i < cycles; ++i)
+    {
+      renderMenu(MENU_CONTEXTUAL, false);
+      renderMenu(MENU_SETTINGS, false);
+      renderMenu(MENU_HISTORY, false);
+      renderMenu(MENU_NONE, false);
+      teardownAllMenus();
+    }
+    timing = false;
+    MemRegionStats stats;
+    mem_policy_stats(MEM_REGION_INTERNAL, stats);
+    printf("[mem_slab_benchmark] slab %s: %u cycles in %u ms, %u allocs avg %u cyc, %u frees avg %u cyc\n",
+           use_slab ? "on " : "off", (unsigned)cycles, (unsigned)(lv_tick_get() - start_ms),
+           (unsigned)alloc_calls, alloc_calls ? (unsigned)(alloc_cycles / alloc_calls) : 0,
+           (unsigned)free_calls, free_calls ? (unsigned)(free_cycles / free_calls) : 0);
+    printf("[mem_slab_benchmark] slab %s: internal free %u B, largest block %u B, frag %u%%\n", use_slab ? "on " : "off",
+           (unsigned)stats.free, (unsigned)stats.largest_free,
+           stats.free ? 100 - (unsigned)((100 * (uint64_t)stats.largest_free) / stats.free) : 0);
+  }
+  slab_set_enabled(was_enabled);
+  slab_report(LOG_LVL_INFO); // part of the benchmark output
+}
+
+void mem_policy_monitor_start(void)
+{
+  lv_timer_create([](lv_timer_t *timer)
+                  { mem_policy_report(); }, MEM_MONITOR_PERIOD_MS, NULL);
+  mem_policy_report();
+}
+
+#endif // LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
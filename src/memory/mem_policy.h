@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// LVGL heap placement (LV_USE_STDLIB_MALLOC = LV_STDLIB_CUSTOM). Small blocks
+// (objects, styles, label text) are hot: the common sizes come from the slab
+// pools (memory/slab.h), the rest from internal SRAM. Large ones (draw layers,
+// image cache, big table arrays) go to PSRAM. Without PSRAM everything falls
+// back to internal RAM.
+//
+// Live, peak and largest free block are tracked per region, and a periodic
+// check warns while there is still headroom if the largest free block shrinks
+// towards the size of the allocations we still need to make.
+
+#define MEM_INTERNAL_MAX_BYTES 1024        // larger LVGL blocks prefer PSRAM
+#define MEM_MONITOR_PERIOD_MS 30000
+#define MEM_WARN_INTERNAL_BLOCK (16 * 1024) // largest internal free block
+#define MEM_WARN_PSRAM_BLOCK (128 * 1024)   // largest PSRAM free block
+#define MEM_WARN_FRAG_PCT 60
+
+enum MemRegion
+{
+  MEM_REGION_INTERNAL,
+  MEM_REGION_PSRAM,
+  MEM_REGION_COUNT
+};
+
+struct MemRegionStats
+{
+  size_t live;      // LVGL bytes in use
+  size_t peak;
+  uint32_t blocks;  // LVGL blocks in use
+  uint32_t failures;
+  size_t free;      // whole heap region, including non-LVGL users
+  size_t min_free;  // low water mark since boot
+  size_t largest_free;
+};
+
+void mem_policy_stats(MemRegion region, MemRegionStats &stats);
+// Prints every region; warns when fragmentation is getting close to failures
+void mem_policy_report(void);
+// Starts the periodic report, called after lv_init
+void mem_policy_monitor_start(void);
+
+// Dev builds: -DMEM_SLAB_BENCH_CYCLES=10000 runs the menu churn benchmark once
+// after boot, with the slab allocator off and then on
+#ifndef MEM_SLAB_BENCH_CYCLES
+#define MEM_SLAB_BENCH_CYCLES 0
+#endif
+#define MEM_SLAB_BENCH_DELAY_MS 10000
+void mem_slab_benchmark(uint32_t cycles);
@@ -0,0 +1,143 @@
+#include "slab.h"
+#include <esp_heap_caps.h>
+#include <stdio.h>
+#include "log/log.h"
+
+#define SLAB_PAGES (SLAB_ARENA_BYTES / SLAB_PAGE_BYTES)
+#define SLAB_NO_CLASS 0xFF
+
+static const uint16_t class_sizes[SLAB_CLASS_COUNT] = {16, 24, 32, 48, 64, 96, 128, 192, 256};
+
+struct FreeBlock
+{
+  FreeBlock *next;
+};
+
+static uint8_t *arena = nullptr;
+static uint8_t page_class[SLAB_PAGES];
+static uint16_t pages_used = 0;
+static FreeBlock *free_lists[SLAB_CLASS_COUNT];
+static SlabClassStats stats[SLAB_CLASS_COUNT];
+static bool enabled = true;
+
+void slab_init(void)
+{
+  if (arena)
+    return;
+  arena = (uint8_t *)heap_caps_aligned_alloc(SLAB_PAGE_BYTES, SLAB_ARENA_BYTES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if (!arena)
+  {
+    LOG_W(MEM, "[slab_init] No room for the arena, slabs disabled\n");
+    return;
+  }
+  for (int i = 0; i < SLAB_PAGES; ++i)
+    page_class[i] = SLAB_NO_CLASS;
+  for (int c = 0; c < SLAB_CLASS_COUNT; ++c)
+    stats[c].block_size = class_sizes[c];
+}
+
+static int class_for(size_t size)
+{
+  for (int c = 0; c < SLAB_CLASS_COUNT; ++c)
+    if (size <= class_sizes[c])
+      return c;
+  return -1;
+}
+
+// Carve the next free page of the arena into blocks of class `cls`
+static bool add_page(int cls)
+{
+  if (pages_used >= SLAB_PAGES)
+    return false;
+  uint8_t *page = arena + pages_used * SLAB_PAGE_BYTES;
+  page_class[pages_used++] = cls;
+  uint16_t size = class_sizes[cls];
+  for (uint32_t offset = 0; offset + size <= SLAB_PAGE_BYTES; offset += size)
+  {
+    FreeBlock *block = (FreeBlock *)(page + offset);
+    block->next = free_lists[cls];
+    free_lists[cls] = block;
+  }
+  stats[cls].pages++;
+  return true;
+}
+
+void *slab_alloc(size_t size)
+{
+  if (!arena || !enabled || size == 0)
+    return nullptr;
+  int cls = class_for(size);
+  if (cls < 0)
+    return nullptr;
+  if (!free_lists[cls] && !add_page(cls))
+  {
+    stats[cls].misses++;
+    return nullptr;
+  }
+  FreeBlock *block = free_lists[cls];
+  free_lists[cls] = block->next;
+  stats[cls].live++;
+  stats[cls].allocs++;
+  return block;
+}
+
+bool slab_owns(const void *p)
+{
+  return arena && (const uint8_t *)p >= arena && (const uint8_t *)p < arena + SLAB_ARENA_BYTES;
+}
+
+static int class_of(const void *p)
+{
+  return page_class[((const uint8_t *)p - arena) / SLAB_PAGE_BYTES];
+}
+
+size_t slab_block_size(const void *p)
+{
+  return class_sizes[class_of(p)];
+}
+
+void slab_free(void *p)
+{
+  int cls = class_of(p);
+  FreeBlock *block = (FreeBlock *)p;
+  block->next = free_lists[cls];
+  free_lists[cls] = block;
+  stats[cls].live--;
+}
+
+void slab_set_enabled(bool enable)
+{
+  enabled = enable;
+}
+
+bool slab_is_enabled(void)
+{
+  return enabled;
+}
+
+size_t slab_live_bytes(void)
+{
+  size_t bytes = 0;
+  for (int c = 0; c < SLAB_CLASS_COUNT; ++c)
+    bytes += (size_t)stats[c].live * class_sizes[c];
+  return bytes;
+}
+
+void slab_class_stats(int cls, SlabClassStats &out)
+{
+  out = stats[cls];
+}
+
+void slab_report(uint8_t level)
+{
+  if (level > LOG_LVL_MEM)
+    return;
+  LOG_AT(MEM, level, "[slab_report] %u/%u pages used, %u B live\n", (unsigned)pages_used, (unsigned)SLAB_PAGES, (unsigned)slab_live_bytes());
+  for (int c = 0; c < SLAB_CLASS_COUNT; ++c)
+  {
+    if (!stats[c].pages && !stats[c].misses)
+      continue;
+    LOG_AT(MEM, level, "[slab_report] %3u B: %u pages, %u live, %u allocs, %u misses\n", (unsigned)stats[c].block_size,
+           (unsigned)stats[c].pages, (unsigned)stats[c].live, (unsigned)stats[c].allocs, (unsigned)stats[c].misses);
+  }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "log/log.h"
+
+// Fixed-size block pools for LVGL's small allocations (objects, event
+// descriptors, style property arrays, label text). A single internal-RAM arena
+// is cut into pages on demand, each page serves one size class and freed blocks
+// go on that class's free list, so menu open/close churn reuses the same
+// blocks instead of fragmenting the general heap. Pages are never given back.
+// Used from the GUI task only, like the rest of LVGL.
+
+#define SLAB_PAGE_BYTES 2048
+#define SLAB_ARENA_BYTES (48 * 1024)
+#define SLAB_CLASS_COUNT 9
+#define SLAB_MAX_BLOCK 256 // larger requests go to the heap
+
+struct SlabClassStats
+{
+  uint16_t block_size;
+  uint16_t pages;
+  uint32_t live;
+  uint32_t allocs;
+  uint32_t misses; // class out of pages, served by the heap
+};
+
+void slab_init(void);
+// nullptr when disabled, too large or out of pages
+void *slab_alloc(size_t size);
+void slab_free(void *p);
+bool slab_owns(const void *p);
+size_t slab_block_size(const void *p);
+// Disabled: new requests go to the heap, blocks already handed out still free here
+void slab_set_enabled(bool enabled);
+bool slab_is_enabled(void);
+size_t slab_live_bytes(void);
+void slab_class_stats(int cls, SlabClassStats &stats);
+// Periodic monitor output is debug level, benchmarks ask for more
+void slab_report(uint8_t level = LOG_LVL_DEBUG);
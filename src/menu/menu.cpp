@@ -4,7 +4,7 @@
 #include "menu.h"
 #include <settings/start_life.h>
 #include <constants/constants.h>
-#include <math.h>
+#include <helpers/polar_zones.h>
 #include <battery/battery_state.h>
 #include <settings/settings_overlay.h>
 #include <life/life_counter.h>
@@ -14,9 +14,12 @@
 #include <history/history.h>
 #include <helpers/event_grouper.h>
 #include "gui_main.h"
+#include "main.h"
 #include <settings/brightness.h>
 #include <timer/timer.h>
 #include <helpers/animation_helpers.h>
+#include <theme/theme.h>
+#include <log/log.h>
 
 extern esp_panel::board::Board *board;
 
@@ -26,10 +29,20 @@ lv_obj_t *settings_menu = nullptr;
 lv_obj_t *life_config_menu = nullptr;
 lv_obj_t *history_menu = nullptr;
 lv_obj_t *brightness_control = nullptr;
-int circle_diameter = SCREEN_WIDTH;
-int circle_radius = circle_diameter / 2;
+static lv_obj_t *lbl_player_mode = nullptr;
 static MenuState currentMenu = MENU_NONE;
 
+// Retained overlays are built on first open and then only hidden/shown.
+// Track what the cache costs in LVGL heap and what it saves per open.
+struct MenuCacheStats
+{
+  uint32_t build_us;   // cold open: widget tree creation + refresh
+  uint32_t retained;   // LVGL heap bytes held while hidden
+  uint32_t last_us;    // most recent warm open
+  uint32_t warm_opens;
+};
+static MenuCacheStats menu_cache_stats[MENU_BRIGHTNESS + 1] = {};
+
 // Forward declarations
 static void togglePlayerMode();
 static void resetActiveCounter();
@@ -37,9 +50,8 @@ static void showHistoryOverlay();
 static void showLifeScreen();
 static void hideLifeScreen();
 void teardownContextualMenuOverlay();
-static bool is_in_center_cancel_area(lv_event_t *e);
+static uint8_t get_menu_zone();
 void renderMenu(MenuState menuType);
-bool is_in_quadrant(lv_event_t *e, int angle_start, int angle_end);
 
 MenuState getCurrentMenu()
 {
@@ -73,9 +85,9 @@ static void togglePlayerMode()
     current_mode = PLAYER_MODE_ONE_PLAYER;
   PlayerMode new_mode = (current_mode == PLAYER_MODE_ONE_PLAYER) ? PLAYER_MODE_TWO_PLAYER : PLAYER_MODE_ONE_PLAYER;
   player_store.putInt(KEY_PLAYER_MODE, (int)new_mode);
-  printf("[togglePlayerMode] Player mode toggled to %d\n", new_mode);
-  // Rerender main GUI (life counter)
-  ui_init(global_indev);
+  LOG_I(UI, "[togglePlayerMode] Player mode toggled to %d\n", new_mode);
+  // Swap to the other prebuilt view; game state carries across
+  switch_player_mode(new_mode);
   renderMenu(MENU_NONE);
 }
 
@@ -91,11 +103,10 @@ static void resetActiveCounter()
   {
     reset_life_2p();
   }
-  printf("[resetActiveCounter] Reset life counter and history for player mode %d\n", player_mode);
+  LOG_I(UI, "[resetActiveCounter] Reset life counter and history for player mode %d\n", player_mode);
 
   reset_timer();
-  showLifeScreen();
-  teardownAllMenus();
+  renderMenu(MENU_NONE);
 }
 
 static void contextual_btn_event_cb(lv_event_t *e)
@@ -104,10 +115,9 @@ static void contextual_btn_event_cb(lv_event_t *e)
   handleContextualSelection(quadrant);
 }
 
-// Draw contextual menu overlay with 4 quadrants using LVGL
-void renderContextualMenuOverlay(bool animate_menu)
+// Build contextual menu overlay with 4 quadrants using LVGL (once, then retained)
+static void buildContextualMenuOverlay()
 {
-  teardownContextualMenuOverlay();
   // Make the overlay a true circle, centered on the screen
   int circle_diameter = (SCREEN_WIDTH < SCREEN_HEIGHT ? SCREEN_WIDTH : SCREEN_HEIGHT); // Increase size by 5 pixels
   int circle_radius = circle_diameter / 2;
@@ -116,11 +126,7 @@ void renderContextualMenuOverlay(bool animate_menu)
 
   contextual_menu = lv_obj_create(lv_scr_act());
   lv_obj_set_size(contextual_menu, circle_diameter, circle_diameter);
-  lv_obj_set_style_bg_color(contextual_menu, lv_color_black(), LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(contextual_menu, LV_OPA_COVER, LV_PART_MAIN);
-  lv_obj_set_style_border_opa(contextual_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_outline_opa(contextual_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_radius(contextual_menu, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+  lv_obj_add_style(contextual_menu, &style_round_overlay, LV_PART_MAIN);
   lv_obj_align(contextual_menu, LV_ALIGN_CENTER, 0, 0);
   lv_obj_clear_flag(contextual_menu, LV_OBJ_FLAG_SCROLLABLE);
 
@@ -133,23 +139,22 @@ void renderContextualMenuOverlay(bool animate_menu)
   // Add quadrant labels directly to the overlay for visual feedback
   lv_obj_t *lbl_tl = lv_label_create(contextual_menu);
   lv_label_set_text(lbl_tl, LV_SYMBOL_SETTINGS);
-  lv_obj_set_style_text_font(lbl_tl, &lv_font_montserrat_40, 0);
+  lv_obj_add_style(lbl_tl, &style_menu_icon, 0);
   lv_obj_align(lbl_tl, LV_ALIGN_CENTER, -ring_radius / 2, -ring_radius / 2);
 
-  lv_obj_t *lbl_tr = lv_label_create(contextual_menu);
-  const char *lbl_text = player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER) == PLAYER_MODE_ONE_PLAYER ? "2P" : "1P";
-  lv_label_set_text(lbl_tr, lbl_text);
-  lv_obj_set_style_text_font(lbl_tr, &lv_font_montserrat_40, 0);
+  lbl_player_mode = lv_label_create(contextual_menu);
+  lv_obj_t *lbl_tr = lbl_player_mode;
+  lv_obj_add_style(lbl_tr, &style_menu_icon, 0);
   lv_obj_align(lbl_tr, LV_ALIGN_CENTER, ring_radius / 2, -ring_radius / 2);
 
   lv_obj_t *lbl_bl = lv_label_create(contextual_menu);
   lv_label_set_text(lbl_bl, LV_SYMBOL_REFRESH);
-  lv_obj_set_style_text_font(lbl_bl, &lv_font_montserrat_40, 0);
+  lv_obj_add_style(lbl_bl, &style_menu_icon, 0);
   lv_obj_align(lbl_bl, LV_ALIGN_CENTER, -ring_radius / 2, ring_radius / 2);
 
   lv_obj_t *lbl_br = lv_label_create(contextual_menu);
   lv_label_set_text(lbl_br, LV_SYMBOL_LIST);
-  lv_obj_set_style_text_font(lbl_br, &lv_font_montserrat_40, 0);
+  lv_obj_add_style(lbl_br, &style_menu_icon, 0);
   lv_obj_align(lbl_br, LV_ALIGN_CENTER, ring_radius / 2, ring_radius / 2);
 
   // Make the overlay itself clickable for quadrant hit detection
@@ -161,19 +166,22 @@ void renderContextualMenuOverlay(bool animate_menu)
   }, LV_EVENT_ALL, NULL);
   lv_obj_add_event_cb(contextual_menu, [](lv_event_t *e)
                       {
-    // Prevent quadrant actions if tap is in the center cancel area
-    if (is_in_center_cancel_area(e)) {
-      // Tap is in the center cancel area; let the button handle it
-      return;
-    }
-    if (is_in_quadrant(e, -180, -90)) {
+    // Single table lookup; the center cancel area is left to its button
+    switch (get_menu_zone()) {
+    case MENU_ZONE_TL:
       handleContextualSelection(QUADRANT_TL);
-    } else if (is_in_quadrant(e, -90, 0)) {
+      break;
+    case MENU_ZONE_TR:
       handleContextualSelection(QUADRANT_TR);
-    } else if (is_in_quadrant(e, 0, 90)) {
+      break;
+    case MENU_ZONE_BR:
       handleContextualSelection(QUADRANT_BR);
-    } else if (is_in_quadrant(e, 90, 180)) {
+      break;
+    case MENU_ZONE_BL:
       handleContextualSelection(QUADRANT_BL);
+      break;
+    default:
+      break;
     } }, LV_EVENT_CLICKED, NULL);
 
   // Center cancel area (empty circle)
@@ -197,13 +205,29 @@ void renderContextualMenuOverlay(bool animate_menu)
   lv_label_set_text(lbl_cancel, LV_SYMBOL_CLOSE);
   lv_obj_set_style_text_font(lbl_cancel, &lv_font_montserrat_48, 0);
   lv_obj_center(lbl_cancel); // Center the label in the cancel button
+}
 
+// Show the contextual menu, building it on first use
+void renderContextualMenuOverlay(bool animate_menu)
+{
+  if (!contextual_menu)
+    buildContextualMenuOverlay();
+  const char *lbl_text = player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER) == PLAYER_MODE_ONE_PLAYER ? "2P" : "1P";
+  lv_label_set_text(lbl_player_mode, lbl_text);
+  lv_obj_clear_flag(contextual_menu, LV_OBJ_FLAG_HIDDEN);
+
+  // A previous close animation may still own the position
+  lv_anim_delete(contextual_menu, NULL);
   if (animate_menu)
   {
     // Animate the contextual menu to slide in from the top
     lv_obj_set_y(contextual_menu, -SCREEN_HEIGHT); // Start above the screen
     slide_in_obj_vertical(contextual_menu, -SCREEN_HEIGHT, 0, 250, 0, nullptr);
   }
+  else
+  {
+    lv_obj_set_y(contextual_menu, 0);
+  }
 }
 
 // Update renderMenu to use LVGL overlays
@@ -212,10 +236,64 @@ void renderMenu(MenuState menuType)
   renderMenu(menuType, true);
 }
 
+// Root object of each retained overlay (history is rebuilt from the event log on every open)
+static lv_obj_t **cachedMenuRoot(MenuState menuType)
+{
+  switch (menuType)
+  {
+  case MENU_CONTEXTUAL:
+    return &contextual_menu;
+  case MENU_SETTINGS:
+    return &settings_menu;
+  case MENU_LIFE_CONFIG:
+    return &life_config_menu;
+  case MENU_BRIGHTNESS:
+    return &brightness_control;
+  default:
+    return nullptr;
+  }
+}
+
+static uint32_t lvglUsedBytes()
+{
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+static void recordMenuOpen(MenuState menuType, bool cold, uint32_t elapsed_us, uint32_t used_before)
+{
+  MenuCacheStats &stats = menu_cache_stats[menuType];
+  if (cold)
+  {
+    stats.build_us = elapsed_us;
+    stats.retained = lvglUsedBytes() - used_before;
+  }
+  else
+  {
+    stats.last_us = elapsed_us;
+    stats.warm_opens++;
+  }
+  LOG_D(UI, "[menu_cache] menu %d %s open: %u us (build %u us, %u bytes retained, %u warm opens)\n",
+         menuType, cold ? "cold" : "warm", elapsed_us, stats.build_us, stats.retained, stats.warm_opens);
+}
+
+uint32_t getMenuCacheBytes()
+{
+  uint32_t total = 0;
+  for (const MenuCacheStats &stats : menu_cache_stats)
+    total += stats.retained;
+  return total;
+}
+
 void renderMenu(MenuState menuType, bool animate_menu)
 {
-  teardownAllMenus();
+  hideAllMenus();
   hideLifeScreen();
+  lv_obj_t **cached_root = cachedMenuRoot(menuType);
+  bool cold = cached_root && *cached_root == nullptr;
+  uint32_t used_before = lvglUsedBytes();
+  uint32_t start_us = micros();
   switch (menuType)
   {
   case MENU_CONTEXTUAL:
@@ -244,41 +322,18 @@ void renderMenu(MenuState menuType, bool animate_menu)
     currentMenu = MENU_NONE;
     break;
   }
+  if (cached_root && *cached_root)
+  {
+    lv_obj_move_foreground(*cached_root); // Stay above a life counter rebuilt since the last open
+    recordMenuOpen(menuType, cold, micros() - start_us, used_before);
+  }
 }
-// Helper for center cancel area hit detection
-static bool is_in_center_cancel_area(lv_event_t *e)
-{
-  lv_point_t p;
-  lv_indev_get_point(lv_indev_get_act(), &p);
-  int x = p.x, y = p.y;
-  int circle_x = (SCREEN_WIDTH - circle_diameter) / 2;
-  int circle_y = (SCREEN_HEIGHT - circle_diameter) / 2;
-  int cx = circle_x + circle_radius;
-  int cy = circle_y + circle_radius;
-  int ring_radius = circle_radius;
-  int dx = x - cx, dy = y - cy;
-  float dist = sqrtf(dx * dx + dy * dy);
-  int hole_radius = ring_radius / 3;
-  return (dist < hole_radius);
-}
-
-// Helper for quadrant hit detection
-bool is_in_quadrant(lv_event_t *e, int angle_start, int angle_end)
+// Helper for contextual menu hit detection via the precomputed polar zone map
+static uint8_t get_menu_zone()
 {
   lv_point_t p;
   lv_indev_get_point(lv_indev_get_act(), &p);
-  int x = p.x, y = p.y;
-  int circle_x = (SCREEN_WIDTH - circle_diameter) / 2;
-  int circle_y = (SCREEN_HEIGHT - circle_diameter) / 2;
-  int cx = circle_x + circle_radius;
-  int cy = circle_y + circle_radius;
-  int ring_diameter = circle_diameter;
-  int ring_radius = ring_diameter / 2;
-  int dx = x - cx, dy = y - cy;
-  float angle = atan2f(dy, dx) * 180.0f / M_PI;
-  float dist = sqrtf(dx * dx + dy * dy);
-  int hole_radius = ring_radius / 3;
-  return (dist >= hole_radius && dist <= ring_radius && angle >= angle_start && angle < angle_end);
+  return polar_zone_lookup(&menu_zone_map, p.x, p.y);
 }
 
 // Extern declarations for life counter objects
@@ -292,14 +347,29 @@ void hideLifeScreen()
   if (life_counter_container_2p)
     lv_obj_add_flag(life_counter_container_2p, LV_OBJ_FLAG_HIDDEN);
 }
+// Only the active mode is shown, the other view stays prebuilt but hidden
 void showLifeScreen()
 {
-  if (life_counter_container)
+  if (life_counter_mode == PLAYER_MODE_ONE_PLAYER && life_counter_container)
     lv_obj_clear_flag(life_counter_container, LV_OBJ_FLAG_HIDDEN);
-  if (life_counter_container_2p)
+  if (life_counter_mode == PLAYER_MODE_TWO_PLAYER && life_counter_container_2p)
     lv_obj_clear_flag(life_counter_container_2p, LV_OBJ_FLAG_HIDDEN);
 }
 
+// Hide every overlay but keep the retained widget trees alive
+void hideAllMenus()
+{
+  currentMenu = MENU_NONE;
+  lv_obj_t *retained[] = {contextual_menu, settings_menu, life_config_menu, brightness_control};
+  for (lv_obj_t *menu : retained)
+  {
+    if (menu)
+      lv_obj_add_flag(menu, LV_OBJ_FLAG_HIDDEN);
+  }
+  teardownHistoryOverlay();
+}
+
+// Delete every overlay, used when the screen they live on is replaced
 void teardownAllMenus()
 {
   currentMenu = MENU_NONE; // Reset current menu state
@@ -317,4 +387,5 @@ void teardownContextualMenuOverlay()
     lv_obj_del(contextual_menu);
     contextual_menu = nullptr;
   }
+  lbl_player_mode = nullptr;
 }
\ No newline at end of file
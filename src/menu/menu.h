@@ -2,5 +2,7 @@
 
 void renderMenu(MenuState menuType);
 void renderMenu(MenuState menuType, bool animate_menu);
+void hideAllMenus();
 void teardownAllMenus();
-MenuState getCurrentMenu();
\ No newline at end of file
+MenuState getCurrentMenu();
+uint32_t getMenuCacheBytes();
@@ -1,20 +1,44 @@
-
 #include "power_key.h"
 #include "shutdown/shutdown.h"
 #include <lvgl.h>
 #include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
 #include <esp_wifi.h>
 #include <esp_bt.h>
 #include <Arduino.h>
-#include <esp_display_panel.hpp>
 #include <state/state_store.h>
 #include <constants/constants.h>
 #include <battery/battery_state.h>
+#include "power_pm.h"
+#include "main.h"
+#include <ambient/ambient.h>
+#include <helpers/refresh_rate.h>
+#include <state/game_snapshot.h>
+#include <state/journal.h>
+#include <log/log.h>
+
+// The power key is edge triggered: the ISR only (re)arms the debounce timer, the
+// timers run the state machine from the esp_timer task. Nothing here blocks or polls.
+static volatile PowerState power_state = POWER_BOOTING;
+static BatteryState BAT_State = BAT_OFF;
+static bool boot_window_open = false;
+static volatile int64_t last_edge_us = 0;
+static int64_t wake_edge_us = 0;
 
-extern esp_panel::board::Board *board;
+// Standby bookkeeping: battery drop over time is the only current proxy on board
+static int64_t standby_start_us = 0;
+static float standby_start_volts = 0;
 
-static BatteryState BAT_State = BAT_OFF;
-static uint32_t button_press_start = 0;
+static esp_timer_handle_t debounce_timer = nullptr;
+static esp_timer_handle_t hold_timer = nullptr;
+static esp_timer_handle_t boot_window_timer = nullptr;
+static esp_timer_handle_t usb_check_timer = nullptr;
+static esp_timer_handle_t deep_sleep_timer = nullptr;
+static esp_timer_handle_t standby_timer = nullptr;
+
+static void enter_deep_sleep(void);
 
 // Helper Functions
 bool is_button_pressed(void)
@@ -22,275 +46,330 @@ bool is_button_pressed(void)
   return (digitalRead(PWR_KEY_Input_PIN) == ButtonState::BUTTON_PRESSED);
 }
 
-// Check if USB is connected by detecting charging voltage
+// Check if USB is connected by detecting charging voltage (cached by the battery service)
 bool is_usb_connected(void)
 {
-  float voltage = battery_get_volts();
-  return (voltage > USB_VOLTAGE_THRESHOLD);
+  return battery_is_usb_connected();
 }
 
-// Helper function: Wait for button to be held for a specified duration (in ms)
-bool wait_for_button_hold(uint16_t hold_ms)
+static const char *power_state_name(PowerState state)
 {
-  uint16_t wake_btn_hold_duration = 0;
-  uint16_t required_count = hold_ms / 10;
-  while (is_button_pressed())
+  switch (state)
   {
-    vTaskDelay(10);
-    wake_btn_hold_duration++;
-    if (wake_btn_hold_duration >= required_count)
-    {
-      return true; // Button held long enough
-    }
+  case POWER_BOOTING:
+    return "booting";
+  case POWER_ON:
+    return "on";
+  case POWER_SCREEN_OFF_USB:
+    return "screen-off-usb";
+  case POWER_SLEEPING:
+    return "sleeping";
+  case POWER_AMBIENT:
+    return "ambient";
+  case POWER_STANDBY:
+    return "standby";
   }
-  return false; // Released before required hold
+  return "?";
 }
 
-void wake_up(void)
+static void set_power_state(PowerState state)
 {
-  pinMode(PWR_KEY_Input_PIN, INPUT);
-  pinMode(PWR_Control_PIN, OUTPUT);
-
-  // Check wake-up reason
-  esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
-  float voltage = battery_get_volts();
-  printf("[wake_up] Wakeup reason: %d, Battery voltage: %.2fV\n", wakeup_reason, voltage);
-
-  // ESP_SLEEP_WAKEUP_EXT0 = woken by power button
-  // ESP_SLEEP_WAKEUP_UNDEFINED = power-on reset (USB plugged in or first boot)
-  if (wakeup_reason == ESP_SLEEP_WAKEUP_EXT0)
-  {
-    // Woken by button press - boot the device
-    printf("[wake_up] Button wake - booting device\n");
-    digitalWrite(PWR_Control_PIN, HIGH);
-    vTaskDelay(100);
-    BAT_State = BAT_ON;
-  }
-  else
-  {
-    // Non-button wake (USB plug, spurious wake, etc.)
-    printf("[wake_up] Non-button wake detected\n");
-
-    // Check if this might be USB by checking voltage
-    // Note: This threshold may become less accurate as battery ages
-    float voltage = battery_get_volts();
-    bool likely_usb = (voltage > USB_VOLTAGE_THRESHOLD);
-    printf("[wake_up] Voltage: %.2fV, likely USB: %s\n", voltage, likely_usb ? "YES" : "NO");
-
-    if (likely_usb)
-    {
-      // Likely USB - stay in stable idle to prevent flash loop
-      printf("[wake_up] USB detected - entering stable idle mode\n");
-      digitalWrite(PWR_Control_PIN, HIGH);
-      vTaskDelay(100);
-
-      uint32_t last_check = 0;
-      while (true)
-      {
-        vTaskDelay(100);
-
-        // Check for button press to boot
-        if (is_button_pressed())
-        {
-          vTaskDelay(50); // Debounce
-          if (is_button_pressed() && wait_for_button_hold(Device_Wake_Time))
-          {
-            printf("[wake_up] Button held - booting device\n");
-            BAT_State = BAT_ON;
-            return; // Exit to boot
-          }
-        }
-
-        // Check voltage every 2 seconds
-        uint32_t now = millis();
-        if (now - last_check > 2000)
-        {
-          float current_voltage = battery_get_volts();
-          if (current_voltage < USB_DISCONNECT_THRESHOLD) // USB disconnected (with hysteresis)
-          {
-            printf("[wake_up] USB disconnected (%.2fV) - entering deep sleep\n", current_voltage);
-            break; // Exit to deep sleep below
-          }
-          last_check = now;
-        }
-      }
-    }
-
-    // No USB detected - check if button is pressed before sleeping
-    printf("[wake_up] No USB detected\n");
+  LOG_I(POWER, "[power] %s -> %s\n", power_state_name(power_state), power_state_name(state));
+  power_state = state;
+}
 
-    // Give user a moment to press button (check for 500ms)
-    bool button_held = false;
-    for (int i = 0; i < 50; i++)
-    {
-      if (is_button_pressed())
-      {
-        vTaskDelay(50); // Debounce
-        if (is_button_pressed() && wait_for_button_hold(Device_Wake_Time))
-        {
-          printf("[wake_up] Button held during wake - booting device\n");
-          digitalWrite(PWR_Control_PIN, HIGH);
-          vTaskDelay(100);
-          BAT_State = BAT_ON;
-          button_held = true;
-          break;
-        }
-      }
-      vTaskDelay(10);
-    }
+static void IRAM_ATTR power_key_isr(void)
+{
+  // Level triggered so the key can also wake light sleep (edges cannot): flip to
+  // the opposite level so each press and release fires once. The gpio_ll calls
+  // are inline, so this stays safe while a flash write has the cache off.
+  bool pressed = (gpio_ll_get_level(&GPIO, PWR_KEY_Input_PIN) == ButtonState::BUTTON_PRESSED);
+  gpio_ll_set_intr_type(&GPIO, PWR_KEY_Input_PIN, pressed ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  last_edge_us = esp_timer_get_time();
+  // Restart the debounce window on every edge
+  esp_timer_stop(debounce_timer);
+  esp_timer_start_once(debounce_timer, POWER_KEY_DEBOUNCE_US);
+}
 
-    // If button was held, boot the device
-    if (button_held)
-    {
-      return;
-    }
+static void power_on(void)
+{
+  esp_timer_stop(usb_check_timer);
+  esp_timer_stop(boot_window_timer);
+  boot_window_open = false;
+  digitalWrite(PWR_Control_PIN, HIGH);
+  // The GUI task wakes the panel and brings the backlight up when it sees POWER_ON
+  if (BAT_State == BAT_ON)
+    ambient_request_wake(); // drop an always-on view left from before the screen went off
+  BAT_State = BAT_ON;
+  set_power_state(POWER_ON);
+  refresh_rate_notify();
+}
 
-    // No button press detected - power down and deep sleep
-    printf("[wake_up] No button press - powering down\n");
-    digitalWrite(PWR_Control_PIN, LOW);
-    vTaskDelay(100);
+// Display off but everything else resident; the GUI task puts the panel to sleep
+static void enter_standby(void)
+{
+  standby_start_us = esp_timer_get_time();
+  standby_start_volts = battery_get_volts();
+  set_power_state(POWER_STANDBY);
+  esp_timer_start_once(standby_timer, STANDBY_TIMEOUT_US);
+  refresh_rate_notify();
+}
 
-    // Configure and enter deep sleep
-    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
-    esp_sleep_enable_ext0_wakeup((gpio_num_t)PWR_KEY_Input_PIN, LOW); // Wake on LOW (button press)
-    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_OFF);
-    esp_sleep_pd_config(ESP_PD_DOMAIN_XTAL, ESP_PD_OPTION_OFF);
+// The GUI task wakes the panel and turns the backlight on when it sees POWER_ON
+static void resume_from_standby(void)
+{
+  esp_timer_stop(standby_timer);
+  wake_edge_us = last_edge_us;
+  float hours = (esp_timer_get_time() - standby_start_us) / 3600e6f;
+  float drop_mv = (standby_start_volts - battery_get_volts()) * 1000.0f;
+  LOG_I(POWER, "[standby] %.2fh in standby, battery %.0fmV lower (%.1fmV/h)\n", hours, drop_mv, hours > 0 ? drop_mv / hours : 0.0f);
+  set_power_state(POWER_ON);
+  refresh_rate_notify();
+}
 
-    printf("[wake_up] Entering deep sleep\n");
-    vTaskDelay(100);
-    esp_deep_sleep_start();
+static void standby_timer_cb(void *arg)
+{
+  if (power_state != POWER_STANDBY)
+    return;
+  LOG_I(POWER, "[standby] Timed out - entering deep sleep\n");
+  enter_deep_sleep();
+}
 
-    // Never reaches here
-    BAT_State = BAT_OFF;
-  }
+// USB connected: keep power on but display off until the key is held or USB goes away
+static void screen_off_on_usb(void)
+{
+  digitalWrite(PWR_Control_PIN, HIGH);
+  set_power_state(POWER_SCREEN_OFF_USB);
+  esp_timer_start_periodic(usb_check_timer, USB_CHECK_PERIOD_US);
+  refresh_rate_notify(); // the GUI task may be waiting without a timeout
 }
 
 void fall_asleep(void)
 {
-  printf("[fall_asleep] Shutting down\n");
+  LOG_I(POWER, "[fall_asleep] Shutting down\n");
 
-  // Turn off display
-  if (board && board->getBacklight())
-  {
-    board->getBacklight()->off();
-  }
+  // The GUI task fades the backlight out and puts the panel to sleep
 
   // Disable peripherals
   esp_wifi_stop();
   esp_bt_controller_disable();
 
-  // Check if USB is connected
-  float voltage = battery_get_volts();
-  bool usb_connected = (voltage > USB_VOLTAGE_THRESHOLD);
-  printf("[fall_asleep] USB connected: %s (%.2fV)\n", usb_connected ? "YES" : "NO", voltage);
+  bool usb_connected = is_usb_connected();
+  LOG_I(POWER, "[fall_asleep] USB connected: %s (%.2fV)\n", usb_connected ? "YES" : "NO", battery_get_volts());
 
   if (usb_connected)
+    screen_off_on_usb();
+  else
+    enter_standby();
+}
+
+// Save the game, drop the power latch, then give it time to settle before deep sleep.
+// On battery the latch drop cuts power once the key is let go, RTC memory with
+// it, so the journal is what brings the game back there; the snapshot only
+// survives when USB keeps the board powered through deep sleep.
+static void enter_deep_sleep(void)
+{
+  esp_timer_stop(usb_check_timer);
+  esp_timer_stop(boot_window_timer);
+  esp_timer_stop(hold_timer);
+  esp_timer_stop(standby_timer);
+  set_power_state(POWER_SLEEPING);
+  refresh_rate_notify(); // park the GUI task
+
+  // Only a device that actually ran a game has anything worth keeping; a boot
+  // that never got past the key check must not overwrite an older snapshot.
+  // The save commits pending groups, so it runs on the loop task that drives
+  // them rather than here on the esp_timer task.
+  if (BAT_State == BAT_ON)
   {
-    // USB connected - keep power on but display off
-    printf("[fall_asleep] USB connected - entering low power mode with display off\n");
-    digitalWrite(PWR_Control_PIN, HIGH);
-    vTaskDelay(100);
-
-    // Simple loop: wait for USB disconnect or button press, then deep sleep
-    uint32_t last_check = 0;
-    while (true)
+    // A call that timed out was withdrawn before it ran, so saving here cannot overlap it
+    if (!loop_task_call(game_snapshot_save))
     {
-      vTaskDelay(100);
-
-      // Check for button press to wake
-      if (is_button_pressed())
-      {
-        vTaskDelay(50); // Debounce
-        if (is_button_pressed() && wait_for_button_hold(Device_Wake_Time))
-        {
-          printf("[fall_asleep] Button held - waking device\n");
-          BAT_State = BAT_ON;
-
-          // Re-enable display
-          if (board && board->getBacklight())
-          {
-            board->getBacklight()->on();
-            int brightness = player_store.getInt(KEY_BRIGHTNESS, 100);
-            board->getBacklight()->setBrightness(brightness);
-          }
-
-          return; // Exit to main loop
-        }
-      }
-
-      // Check voltage every 2 seconds
-      uint32_t now = millis();
-      if (now - last_check > 2000) // Check every 2 seconds
-      {
-        float current_voltage = battery_get_volts();
-
-        if (current_voltage < USB_DISCONNECT_THRESHOLD) // USB disconnected (with hysteresis)
-        {
-          printf("[fall_asleep] USB disconnected (%.2fV) - entering deep sleep\n", current_voltage);
-          digitalWrite(PWR_Control_PIN, LOW);
-          vTaskDelay(100);
-          break; // Exit loop to deep sleep below
-        }
-
-        last_check = now;
-      }
+      LOG_W(POWER, "[power] Loop task busy, saving the snapshot from the timer task\n");
+      game_snapshot_save();
     }
+    if (!journal_sync(POWER_JOURNAL_SYNC_MS))
+      LOG_W(POWER, "[power] Journal not synced before power off\n");
   }
-  else
-  {
-    // No USB - power off immediately
-    printf("[fall_asleep] No USB - powering off\n");
-    digitalWrite(PWR_Control_PIN, LOW);
-    vTaskDelay(100);
-  }
+  digitalWrite(PWR_Control_PIN, LOW);
+  esp_timer_start_once(deep_sleep_timer, POWER_LATCH_SETTLE_US);
+}
 
+static void deep_sleep_timer_cb(void *arg)
+{
   // Configure deep sleep
   esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
   esp_sleep_enable_ext0_wakeup((gpio_num_t)PWR_KEY_Input_PIN, LOW); // Wake on LOW (button press)
   esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_OFF);
   esp_sleep_pd_config(ESP_PD_DOMAIN_XTAL, ESP_PD_OPTION_OFF);
 
-  printf("[fall_asleep] Entering deep sleep\n");
-  vTaskDelay(100);
+  LOG_I(POWER, "[power] Entering deep sleep\n");
+  log_flush();
   esp_deep_sleep_start();
 }
 
-void power_loop(void)
+// Key state settled: start timing a hold, or react to the release
+static void debounce_timer_cb(void *arg)
 {
-  if (BAT_State == BAT_ON)
+  if (power_state == POWER_SLEEPING)
+    return;
+  if (is_button_pressed())
   {
-    // Check for button hold to sleep
-    if (is_button_pressed())
-    {
-      if (button_press_start == 0)
-      {
-        button_press_start = millis();
-      }
-
-      uint32_t held_time = millis() - button_press_start;
-      if (held_time >= Device_Sleep_Time)
-      {
-        printf("[power_loop] Button held - entering sleep\n");
-        button_press_start = 0;
-        fall_asleep();
-        // After deep sleep wake, execution starts from setup()
-        // This line only reached if we return from USB charging loop
-      }
-    }
-    else
+    // Standby resumes on a plain press, no hold needed
+    if (power_state == POWER_STANDBY)
     {
-      // Button released - reset timer
-      button_press_start = 0;
+      resume_from_standby();
+      return;
     }
+    // A press in the always-on view brings the UI back; holding on still sleeps
+    if (power_state == POWER_AMBIENT)
+      ambient_request_wake();
+    bool running = (power_state == POWER_ON || power_state == POWER_AMBIENT);
+    uint64_t hold_us = running ? (uint64_t)(Device_Sleep_Time) * 1000 : (uint64_t)(Device_Wake_Time) * 1000;
+    esp_timer_stop(hold_timer);
+    esp_timer_start_once(hold_timer, hold_us);
+    return;
+  }
+  esp_timer_stop(hold_timer);
+  // Released before the hold completed after the boot window closed
+  if (power_state == POWER_BOOTING && !boot_window_open)
+  {
+    LOG_I(POWER, "[power] No button hold - powering down\n");
+    enter_deep_sleep();
+  }
+}
+
+// Key held long enough
+static void hold_timer_cb(void *arg)
+{
+  if (!is_button_pressed())
+    return;
+  switch (power_state)
+  {
+  case POWER_ON:
+  case POWER_AMBIENT:
+    LOG_I(POWER, "[power] Button held - entering sleep\n");
+    fall_asleep();
+    break;
+  case POWER_BOOTING:
+  case POWER_SCREEN_OFF_USB:
+    LOG_I(POWER, "[power] Button held - booting device\n");
+    power_on();
+    break;
+  case POWER_SLEEPING:
+  case POWER_STANDBY:
+    break;
+  }
+}
+
+// Non-button wake without USB: give the user a moment to press the key
+static void boot_window_timer_cb(void *arg)
+{
+  boot_window_open = false;
+  if (power_state == POWER_BOOTING && !is_button_pressed())
+  {
+    LOG_I(POWER, "[power] No button press - powering down\n");
+    enter_deep_sleep();
+  }
+}
+
+static void usb_check_timer_cb(void *arg)
+{
+  if (power_state == POWER_SCREEN_OFF_USB && !is_usb_connected()) // USB disconnected (with hysteresis)
+  {
+    LOG_I(POWER, "[power] USB disconnected (%.2fV) - entering deep sleep\n", battery_get_volts());
+    enter_deep_sleep();
   }
 }
 
+static esp_timer_handle_t create_power_timer(esp_timer_cb_t cb, const char *name)
+{
+  esp_timer_create_args_t args = {};
+  args.callback = cb;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = name;
+  esp_timer_handle_t handle = nullptr;
+  ESP_ERROR_CHECK(esp_timer_create(&args, &handle));
+  return handle;
+}
+
+void wake_up(void)
+{
+  // Check wake-up reason
+  esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
+  LOG_I(POWER, "[wake_up] Wakeup reason: %d, Battery voltage: %.2fV\n", wakeup_reason, battery_get_volts());
+
+  // ESP_SLEEP_WAKEUP_EXT0 = woken by power button
+  // ESP_SLEEP_WAKEUP_UNDEFINED = power-on reset (USB plugged in or first boot)
+  if (wakeup_reason == ESP_SLEEP_WAKEUP_EXT0)
+  {
+    // Woken by button press - boot the device
+    LOG_I(POWER, "[wake_up] Button wake - booting device\n");
+    power_on();
+  }
+  else if (is_usb_connected())
+  {
+    // Likely USB - stay in stable idle to prevent flash loop
+    LOG_I(POWER, "[wake_up] USB detected - entering stable idle mode\n");
+    screen_off_on_usb();
+  }
+  else
+  {
+    LOG_I(POWER, "[wake_up] No USB detected\n");
+    boot_window_open = true;
+    esp_timer_start_once(boot_window_timer, POWER_BOOT_WINDOW_US);
+  }
+
+  // Catch a key that is already down (e.g. still held from the wake press)
+  if (is_button_pressed())
+    esp_timer_start_once(debounce_timer, POWER_KEY_DEBOUNCE_US);
+}
+
 void power_init(void)
 {
+  pinMode(PWR_KEY_Input_PIN, INPUT);
+  pinMode(PWR_Control_PIN, OUTPUT);
+
+  debounce_timer = create_power_timer(debounce_timer_cb, "pwr_debounce");
+  hold_timer = create_power_timer(hold_timer_cb, "pwr_hold");
+  boot_window_timer = create_power_timer(boot_window_timer_cb, "pwr_boot_window");
+  usb_check_timer = create_power_timer(usb_check_timer_cb, "pwr_usb_check");
+  deep_sleep_timer = create_power_timer(deep_sleep_timer_cb, "pwr_deep_sleep");
+  standby_timer = create_power_timer(standby_timer_cb, "pwr_standby");
+
   wake_up();
+  // ONLOW_WE also enables the pin as a light sleep wake source
+  attachInterrupt(digitalPinToInterrupt(PWR_KEY_Input_PIN), power_key_isr, ONLOW_WE);
 }
 
 BatteryState get_battery_state(void)
 {
   return BAT_State;
 }
+
+PowerState get_power_state(void)
+{
+  return power_state;
+}
+
+void power_enter_ambient(void)
+{
+  if (power_state == POWER_ON)
+    set_power_state(POWER_AMBIENT);
+}
+
+void power_exit_ambient(void)
+{
+  if (power_state == POWER_AMBIENT)
+    set_power_state(POWER_ON);
+}
+
+bool power_display_wanted(void)
+{
+  return power_state == POWER_ON || power_state == POWER_AMBIENT;
+}
+
+int64_t power_last_wake_us(void)
+{
+  return wake_edge_us;
+}
@@ -8,12 +8,12 @@
 #define Device_Wake_Time 2 * 1000  // 2 seconds (assuming loop rate is 50Hz)
 #define Device_Sleep_Time 3 * 1000 // 3 seconds (assuming loop rate is 50Hz)
 
-// USB detection voltage threshold
-// USB charging: ~4.16-4.19V, Battery only: ~3.7-4.16V, Threshold: 4.15V
-// Set high enough to reliably detect USB charging vs battery
-// Uses hysteresis: higher to detect USB, lower to confirm disconnect
-#define USB_VOLTAGE_THRESHOLD 4.15f
-#define USB_DISCONNECT_THRESHOLD 4.12f
+#define POWER_KEY_DEBOUNCE_US (30 * 1000)  // key must be stable this long
+#define POWER_BOOT_WINDOW_US (500 * 1000)  // non-button wake: time to press the key
+#define POWER_LATCH_SETTLE_US (100 * 1000) // after dropping PWR_Control before deep sleep
+#define POWER_JOURNAL_SYNC_MS 300          // last journal page, before the latch drops
+#define USB_CHECK_PERIOD_US (2000 * 1000)  // USB presence check while the screen is off
+#define STANDBY_TIMEOUT_US (30ULL * 60 * 1000 * 1000) // standby this long drops to deep sleep
 
 // Button state enum for clarity
 enum ButtonState
@@ -29,8 +29,26 @@ enum BatteryState
   BAT_ON = 1
 };
 
+// Power state machine, driven by the power key interrupt and esp_timers
+enum PowerState
+{
+  POWER_BOOTING = 0,        // non-button wake, waiting for a key hold
+  POWER_ON = 1,             // running with the display on
+  POWER_SCREEN_OFF_USB = 2, // display off, kept powered while USB is connected
+  POWER_SLEEPING = 3,       // power latch dropped, entering deep sleep
+  POWER_AMBIENT = 4,        // dimmed always-on view, any touch or key press wakes
+  POWER_STANDBY = 5         // panel asleep, backlight off, RAM and UI kept; a key press resumes
+};
+
 void fall_asleep(void);
 void wake_up(void);
 void power_init(void);
-void power_loop(void);
-BatteryState get_battery_state(void);
\ No newline at end of file
+BatteryState get_battery_state(void);
+PowerState get_power_state(void);
+// Called by the always-on display on the GUI task
+void power_enter_ambient(void);
+void power_exit_ambient(void);
+// True while the panel should be lit and rendering (on or ambient)
+bool power_display_wanted(void);
+// Time of the key edge that ended the last standby, for wake latency logging
+int64_t power_last_wake_us(void);
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "power_pm.h"
+#include "power_key.h"
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include "log/log.h"
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t locks[PM_LOCK_COUNT] = {};
+static bool held[PM_LOCK_COUNT] = {};
+#endif
+
+void pm_init(void)
+{
+#if CONFIG_PM_ENABLE
+  const struct
+  {
+    esp_pm_lock_type_t type;
+    const char *name;
+  } lock_defs[PM_LOCK_COUNT] = {
+      {ESP_PM_CPU_FREQ_MAX, "render"},
+      {ESP_PM_APB_FREQ_MAX, "flush"},
+      {ESP_PM_APB_FREQ_MAX, "touch"},
+      {ESP_PM_NO_LIGHT_SLEEP, "backlight"},
+  };
+  for (int i = 0; i < PM_LOCK_COUNT; ++i)
+    esp_pm_lock_create(lock_defs[i].type, 0, lock_defs[i].name, &locks[i]);
+
+  // The power key and touch INT wake the CPU from light sleep. Both ISRs keep
+  // their pin level triggered, see power_key.cpp and touch.cpp.
+  esp_sleep_enable_gpio_wakeup();
+
+  esp_pm_config_t config = {};
+  config.max_freq_mhz = PM_MAX_FREQ_MHZ;
+  config.min_freq_mhz = PM_MIN_FREQ_MHZ;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  config.light_sleep_enable = true;
+#else
+  config.light_sleep_enable = false; // needs tickless idle in sdkconfig
+#endif
+  esp_err_t err = esp_pm_configure(&config);
+  LOG_I(POWER, "[pm_init] DFS %d-%dMHz, light sleep: %s (%s)\n", PM_MIN_FREQ_MHZ, PM_MAX_FREQ_MHZ,
+         config.light_sleep_enable ? "on" : "off", esp_err_to_name(err));
+#else
+  LOG_I(POWER, "[pm_init] CONFIG_PM_ENABLE is off, running at full clock\n");
+#endif
+}
+
+void pm_lock(PmLock lock)
+{
+#if CONFIG_PM_ENABLE
+  // Locks are counted by IDF; keep each one binary so callers can lock/unlock freely
+  if (!locks[lock] || held[lock])
+    return;
+  held[lock] = true;
+  esp_pm_lock_acquire(locks[lock]);
+#endif
+}
+
+void pm_unlock(PmLock lock)
+{
+#if CONFIG_PM_ENABLE
+  if (!locks[lock] || !held[lock])
+    return;
+  held[lock] = false;
+  esp_pm_lock_release(locks[lock]);
+#endif
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+
+// Power management: dynamic frequency scaling plus automatic light sleep when
+// every task is idle. Code that needs full speed (or must not be slept through)
+// holds one of these locks for the duration of the work.
+
+#define PM_MAX_FREQ_MHZ 240
+#define PM_MIN_FREQ_MHZ 80 // APB users (UART, I2C, SPI) pin the bus at 80MHz anyway
+
+enum PmLock
+{
+  PM_LOCK_RENDER,    // lv_timer_handler: CPU at max
+  PM_LOCK_FLUSH,     // pixels going out over QSPI: APB at max
+  PM_LOCK_TOUCH,     // I2C touch read: APB at max
+  PM_LOCK_BACKLIGHT, // backlight PWM stuck on a clock light sleep stops: no light sleep
+  PM_LOCK_COUNT
+};
+
+void pm_init(void);
+void pm_lock(PmLock lock);
+void pm_unlock(PmLock lock);
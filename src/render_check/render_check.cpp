@@ -0,0 +1,212 @@
+#include "render_check.h"
+
+#if RENDER_CHECK
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "main.h"
+#include "gui_main.h"
+#include "constants/constants.h"
+#include "helpers/arc_update.h"
+#include "images/logo.h"
+#include "life/life_counter.h"
+#include "life/life_counter2P.h"
+#include "menu/menu.h"
+#include "settings/settings_overlay.h"
+#include "state/journal.h"
+#include "replay/game_stash.h"
+#include "state/life_model.h"
+#include "state/state_store.h"
+#include "timer/timer.h"
+
+#define FULL_SCREEN_PIXELS (SCREEN_WIDTH * SCREEN_HEIGHT)
+
+struct RenderCheckCase
+{
+  const char *name;
+  void (*setup)();
+  uint32_t max_pixels; // flushed while switching to the screen
+  uint32_t max_us;     // time for that refresh
+};
+
+static bool measuring = false;
+static uint32_t flushed_pixels = 0;
+static uint32_t frame_crc = 0;
+static lv_obj_t *splash = nullptr;
+
+void render_check_flush(const lv_area_t *area, const uint8_t *px_map)
+{
+  if (!measuring)
+    return;
+  uint32_t pixels = lv_area_get_size(area);
+  flushed_pixels += pixels;
+  // Partial buffers arrive in the same order on every full redraw
+  frame_crc = esp_rom_crc32_le(frame_crc, px_map, pixels * sizeof(uint16_t));
+}
+
+// --- Case setup, all without animations so frames are deterministic ---
+
+static void show_1p(int life);
+
+// The boot frame ui_init draws: the opaque logo on the black screen, before any
+// counter exists. The splash fades the backlight, so this is its only frame.
+static void show_splash()
+{
+  show_1p(DEFAULT_LIFE_MAX);
+  splash = lv_obj_create(lv_layer_top());
+  lv_obj_remove_style_all(splash);
+  lv_obj_set_size(splash, SCREEN_WIDTH, SCREEN_HEIGHT);
+  lv_obj_set_style_bg_color(splash, lv_color_black(), LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(splash, LV_OPA_COVER, LV_PART_MAIN);
+  lv_obj_t *splash_logo = lv_img_create(splash);
+  lv_img_set_src(splash_logo, &logo);
+  lv_obj_align(splash_logo, LV_ALIGN_CENTER, 0, 0);
+}
+
+static void hide_splash()
+{
+  if (splash)
+  {
+    lv_obj_delete(splash);
+    splash = nullptr;
+  }
+}
+
+static void show_1p(int life)
+{
+  hide_splash();
+  renderMenu(MENU_NONE, false);
+  if (life_counter_mode != PLAYER_MODE_ONE_PLAYER)
+    switch_player_mode(PLAYER_MODE_ONE_PLAYER);
+  event_grouper.resetHistory(life);
+  life_model_set_pending(PLAYER_SINGLE, 0);
+  life_model_set_total(PLAYER_SINGLE, life);
+}
+
+static void show_2p(int life_p1, int life_p2)
+{
+  hide_splash();
+  renderMenu(MENU_NONE, false);
+  if (life_counter_mode != PLAYER_MODE_TWO_PLAYER)
+    switch_player_mode(PLAYER_MODE_TWO_PLAYER);
+  event_grouper_p1.resetHistory(life_p1);
+  event_grouper_p2.resetHistory(life_p2);
+  life_model_set_pending(PLAYER_ONE, 0);
+  life_model_set_pending(PLAYER_TWO, 0);
+  life_model_set_total(PLAYER_ONE, life_p1);
+  life_model_set_total(PLAYER_TWO, life_p2);
+}
+
+// 1P history with `count` alternating hits and heals
+static void show_history(int count)
+{
+  show_1p(DEFAULT_LIFE_MAX);
+  std::vector<LifeHistoryEvent> events;
+  int total = DEFAULT_LIFE_MAX;
+  for (int i = 0; i < count; ++i)
+  {
+    int change = (i % 3 == 2) ? 2 : -1;
+    total += change;
+    events.push_back({change, total, PLAYER_SINGLE, (uint32_t)(i * 10000), i * 10});
+  }
+  event_grouper.restoreHistory(total, events);
+  life_model_set_total(PLAYER_SINGLE, total);
+  renderMenu(MENU_HISTORY, false);
+}
+
+static const RenderCheckCase cases[] = {
+    {"splash", []() { show_splash(); }, FULL_SCREEN_PIXELS, 40000},
+    {"1p_40", []() { show_1p(40); }, FULL_SCREEN_PIXELS, 40000},
+    {"1p_39", []() { show_1p(39); }, FULL_SCREEN_PIXELS / 4, 15000}, // one tap: label + arc slice
+    {"1p_20", []() { show_1p(20); }, FULL_SCREEN_PIXELS / 2, 25000},
+    {"1p_5", []() { show_1p(5); }, FULL_SCREEN_PIXELS / 2, 25000},
+    {"2p_40_40", []() { show_2p(40, 40); }, FULL_SCREEN_PIXELS, 40000},
+    {"2p_15_30", []() { show_2p(15, 30); }, FULL_SCREEN_PIXELS / 2, 25000},
+    {"2p_0_1", []() { show_2p(0, 1); }, FULL_SCREEN_PIXELS / 2, 25000},
+    {"menu_contextual", []() { show_1p(40); renderMenu(MENU_CONTEXTUAL, false); }, FULL_SCREEN_PIXELS, 40000},
+    {"menu_settings", []() { renderMenu(MENU_SETTINGS, false); }, FULL_SCREEN_PIXELS, 40000},
+    {"menu_life_config", []() { renderMenu(MENU_LIFE_CONFIG, false); }, FULL_SCREEN_PIXELS, 40000},
+    {"menu_brightness", []() { renderMenu(MENU_BRIGHTNESS, false); }, FULL_SCREEN_PIXELS, 40000},
+    {"history_10", []() { show_history(10); }, FULL_SCREEN_PIXELS, 50000},
+    {"history_200", []() { show_history(200); }, FULL_SCREEN_PIXELS, 50000},
+};
+
+// Per device baselines, one per case and settings
+static StateStore &baseline_store()
+{
+  static StateStore store("render_check");
+  return store;
+}
+
+// Hash of the settings that change frames
+static uint32_t settings_fingerprint(void)
+{
+  uint32_t values[] = {
+      (uint32_t)player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX),
+      (uint32_t)player_store.getInt(KEY_AMP_MODE, 0),
+      (uint32_t)player_store.getInt(KEY_SHOW_TIMER, 0),
+      (uint32_t)player_store.getInt(KEY_BRIGHTNESS, 100)};
+  return esp_rom_crc32_le(0, (const uint8_t *)values, sizeof(values));
+}
+
+void render_check_run(void)
+{
+  uint32_t settings = settings_fingerprint();
+  printf("[render_check_run] %u cases, settings 0x%08x%s\n", (unsigned)(sizeof(cases) / sizeof(cases[0])),
+         (unsigned)settings, RENDER_CHECK_RECORD ? ", recording baselines" : "");
+  game_stash_save();
+  journal_pause(true);
+  pinSettingsBattery(true);
+  reset_timer(); // the stopwatch label is part of the frame
+  lv_display_t *display = lv_display_get_default();
+  int failures = 0;
+  for (const RenderCheckCase &c : cases)
+  {
+    uint64_t arc_px_before = arc_update_stats().total_px;
+    c.setup();
+    lv_anim_delete_all(); // menus and counters may still start fades
+    life_model_flush();
+    uint32_t arc_pixels = (uint32_t)(arc_update_stats().total_px - arc_px_before);
+
+    // What the switch itself costs
+    flushed_pixels = 0;
+    measuring = true;
+    uint32_t start_us = micros();
+    lv_refr_now(display);
+    uint32_t render_us = micros() - start_us;
+    uint32_t pixels = flushed_pixels;
+
+    // Full redraw for the baseline hash
+    frame_crc = 0;
+    lv_obj_invalidate(lv_screen_active());
+    lv_refr_now(display);
+    measuring = false;
+
+    char key[16];
+    snprintf(key, sizeof(key), "rc%08x", (unsigned)esp_rom_crc32_le(settings, (const uint8_t *)c.name, strlen(c.name)));
+#if RENDER_CHECK_RECORD
+    baseline_store().putInt(key, frame_crc);
+#endif
+    uint32_t baseline = (uint32_t)baseline_store().getInt(key, 0);
+
+    bool pixels_ok = pixels <= c.max_pixels;
+    bool time_ok = render_us <= c.max_us;
+    bool baseline_ok = baseline != 0 && baseline == frame_crc;
+    if (!pixels_ok || !time_ok || !baseline_ok)
+      failures++;
+    printf("[render_check_run] %-16s %s pixels %6u/%6u %s time %5u/%5u us crc 0x%08x baseline %s (arc %u)\n",
+           c.name, pixels_ok ? "ok  " : "FAIL", (unsigned)pixels, (unsigned)c.max_pixels,
+           time_ok ? "ok  " : "FAIL", (unsigned)render_us, (unsigned)c.max_us, (unsigned)frame_crc,
+           !baseline ? "none" : baseline_ok ? "ok  " : "FAIL", (unsigned)arc_pixels);
+  }
+  hide_splash();
+  pinSettingsBattery(false);
+  renderMenu(MENU_NONE, false);
+  game_stash_restore();
+  journal_pause(false);
+  printf("[render_check_run] %d failed\n", failures);
+}
+
+#endif // RENDER_CHECK
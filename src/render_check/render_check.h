@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include <lvgl.h>
+
+// On-device render self-check. With -DRENDER_CHECK=1 every screen is set up in
+// turn (splash, 1P and 2P counters at several totals, menus, history, brightness)
+// and checked three ways:
+//  - the pixels flushed to get there and the time it took stay within budget,
+//    which catches "this change doubled the invalidated area" regressions
+//  - a full redraw hashes to the baseline CRC recorded for the case, which
+//    catches visual ones
+// Baselines live in NVS, one per case and settings (life max, timer shown, amp
+// mode, brightness all change frames). They are only written by a run built with
+// -DRENDER_CHECK_RECORD=1, after the frames were checked by eye; a case without
+// one fails. The battery label shows a fixed reading during the check.
+
+#ifndef RENDER_CHECK
+#define RENDER_CHECK 0
+#endif
+
+#ifndef RENDER_CHECK_RECORD
+#define RENDER_CHECK_RECORD 0
+#endif
+
+#define RENDER_CHECK_DELAY_MS 10000 // let the boot sweep finish first
+
+// Called by flush_cb with each area before the byte swap
+void render_check_flush(const lv_area_t *area, const uint8_t *px_map);
+// Runs every case once and prints the results, then puts the game back
+void render_check_run(void);
@@ -0,0 +1,58 @@
+#include "game_stash.h"
+#include <utility>
+#include "constants/constants.h"
+#include "main.h"
+#include "gui_main.h"
+#include "state/life_model.h"
+#include "helpers/event_grouper.h"
+#include "life/life_counter.h"
+#include "life/life_counter2P.h"
+#include "timer/timer.h"
+#include "log/log.h"
+
+// Indexed by player id
+static EventGrouper *const live_groupers[] = {&event_grouper, &event_grouper_p1, &event_grouper_p2};
+static EventGrouper stash_groupers[3];
+static PlayerMode stash_mode;
+static int stash_amp = 0;
+static int stash_elapsed = 0;
+static bool stash_running = false;
+static bool stash_valid = false;
+
+void game_stash_save(void)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    live_groupers[i]->commitNow(); // a pending group would commit into the harness's game
+    stash_groupers[i] = *live_groupers[i];
+    // A group that netted out to 0 keeps its hook; the copy must never call it
+    stash_groupers[i].clearCommitCallback();
+  }
+  stash_mode = life_counter_mode;
+  stash_amp = life_model_get_amp();
+  stash_elapsed = get_elapsed_seconds();
+  stash_running = get_is_timer_running();
+  stash_valid = true;
+}
+
+void game_stash_restore(void)
+{
+  if (!stash_valid)
+    return;
+  stash_valid = false;
+  for (int i = 0; i < 3; ++i)
+  {
+    std::swap(*live_groupers[i], stash_groupers[i]);
+    stash_groupers[i] = EventGrouper(); // free the harness's history and its hook
+  }
+  if (life_counter_mode != stash_mode)
+    switch_player_mode(stash_mode);
+  for (int i = 0; i < 3; ++i)
+  {
+    life_model_set_pending(i, 0);
+    life_model_set_total(i, live_groupers[i]->getLifeTotal());
+  }
+  life_model_set_amp(stash_amp);
+  restore_timer(stash_elapsed, stash_running);
+  LOG_D(STATE, "[game_stash_restore] Game from before the run is back\n");
+}
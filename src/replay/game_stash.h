@@ -0,0 +1,9 @@
+#pragma once
+
+// In-RAM copy of the game for dev harnesses (replay, render check, touch replay,
+// journal benchmark) that take over the counters with the journal paused.
+// Restoring puts the game back on screen, so the journal and the next snapshot
+// agree with it again.
+
+void game_stash_save(void);
+void game_stash_restore(void);
@@ -0,0 +1,283 @@
+#include "replay.h"
+#include <Arduino.h>
+#include <lvgl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "gui_main.h"
+#include "helpers/game_clock.h"
+#include "life/life_counter.h"
+#include "life/life_counter2P.h"
+#include "menu/menu.h"
+#include "state/journal.h"
+#include "replay/game_stash.h"
+#include "state/life_model.h"
+
+static uint32_t virtual_start_ms = 0; // millis() at the start, keeps timestamps after real ones
+static uint32_t virtual_now = 0;      // relative to virtual_start_ms
+
+static uint32_t replay_clock_ms()
+{
+  return virtual_start_ms + virtual_now;
+}
+
+static int replay_clock_seconds()
+{
+  return virtual_now / 1000;
+}
+
+static void timing_add(ReplayTiming &timing, uint32_t us)
+{
+  timing.count++;
+  timing.total_us += us;
+  if (us > timing.max_us)
+    timing.max_us = us;
+}
+
+static uint32_t timing_avg(const ReplayTiming &timing)
+{
+  return timing.count ? (uint32_t)(timing.total_us / timing.count) : 0;
+}
+
+static EventGrouper *const groupers[] = {&event_grouper, &event_grouper_p1, &event_grouper_p2};
+
+static bool any_commit_pending()
+{
+  for (EventGrouper *grouper : groupers)
+    if (grouper->isCommitPending())
+      return true;
+  return false;
+}
+
+// Same work as loop(), timing the calls that end up committing a group
+static void run_loops(ReplayReport &report)
+{
+  for (EventGrouper *grouper : groupers)
+  {
+    if (!grouper->isCommitPending())
+      continue;
+    uint32_t start_us = micros();
+    grouper->loop();
+    if (!grouper->isCommitPending())
+      timing_add(report.commit, micros() - start_us);
+  }
+}
+
+// Jump straight to `target`, unless a group is pending: then step like loop()
+// does so the commit lands at the same virtual time it would on the device
+static void advance_to(uint32_t target, ReplayReport &report)
+{
+  while (virtual_now < target)
+  {
+    if (any_commit_pending())
+      virtual_now = (target - virtual_now > REPLAY_STEP_MS) ? virtual_now + REPLAY_STEP_MS : target;
+    else
+      virtual_now = target;
+    run_loops(report);
+  }
+}
+
+static void apply_step(const ReplayStep &step)
+{
+  switch (step.op)
+  {
+  case REPLAY_LIFE:
+    if (step.player == PLAYER_SINGLE)
+      queue_life_change(PLAYER_SINGLE, step.value);
+    else
+      queue_life_change_2p(step.player, step.value);
+    break;
+  case REPLAY_UNDO:
+    undo_life_change();
+    break;
+  case REPLAY_RESET:
+    if (life_counter_mode == PLAYER_MODE_ONE_PLAYER)
+      reset_life();
+    else
+      reset_life_2p();
+    break;
+  case REPLAY_MODE:
+    switch_player_mode((PlayerMode)step.value);
+    break;
+  case REPLAY_MENU:
+    renderMenu((MenuState)step.value, false);
+    break;
+  case REPLAY_TICK:
+    break;
+  }
+}
+
+static const char *const op_names[] = {"life", "undo", "reset", "mode", "menu", "tick"};
+
+bool replay_parse(const char *script, std::vector<ReplayStep> &steps)
+{
+  int line_no = 0;
+  while (script && *script)
+  {
+    const char *end = strchr(script, '\n');
+    size_t len = end ? (size_t)(end - script) : strlen(script);
+    char line[64];
+    if (len >= sizeof(line))
+      len = sizeof(line) - 1;
+    memcpy(line, script, len);
+    line[len] = '\0';
+    script = end ? end + 1 : nullptr;
+    line_no++;
+
+    char op[8] = "";
+    unsigned long at_ms = 0;
+    int player = 0;
+    int value = 0;
+    if (line[0] == '#' || sscanf(line, "%lu %7s %d %d", &at_ms, op, &player, &value) < 2)
+      continue;
+    // Single-argument ops take their argument as the value
+    if (strcmp(op, "mode") == 0 || strcmp(op, "menu") == 0)
+      value = player;
+    ReplayStep step = {(uint32_t)at_ms, REPLAY_TICK, (int8_t)player, (int16_t)value};
+    size_t i = 0;
+    for (; i < sizeof(op_names) / sizeof(op_names[0]); ++i)
+      if (strcmp(op, op_names[i]) == 0)
+        break;
+    if (i == sizeof(op_names) / sizeof(op_names[0]))
+    {
+      printf("[replay_parse] Line %d: unknown op '%s'\n", line_no, op);
+      return false;
+    }
+    step.op = (ReplayOp)i;
+    steps.push_back(step);
+  }
+  return true;
+}
+
+// xorshift32, so a seed always generates the same game
+static uint32_t next_random(uint32_t &state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+std::vector<ReplayStep> replay_generate_game(uint32_t minutes, uint32_t seed, PlayerMode mode)
+{
+  std::vector<ReplayStep> steps;
+  uint32_t state = seed ? seed : 1;
+  uint32_t end_ms = minutes * 60000;
+  uint32_t next_history_ms = 15 * 60000;
+  uint32_t t = 0;
+  while (t < end_ms)
+  {
+    t += 5000 + next_random(state) % 35000; // next interaction in 5-40s
+    int8_t player = (mode == PLAYER_MODE_ONE_PLAYER) ? PLAYER_SINGLE : (int8_t)(PLAYER_ONE + next_random(state) % 2);
+    int16_t sign = (next_random(state) % 10 < 7) ? -1 : 1; // mostly damage
+    int16_t amount = (next_random(state) % 8 == 0) ? 5 : 1;
+    int taps = 1 + next_random(state) % 6;
+    for (int i = 0; i < taps; ++i)
+    {
+      steps.push_back({t, REPLAY_LIFE, player, (int16_t)(sign * amount)});
+      t += 150 + next_random(state) % 250;
+    }
+    if (mode == PLAYER_MODE_ONE_PLAYER && next_random(state) % 50 == 0)
+      steps.push_back({t + 2000, REPLAY_UNDO, PLAYER_SINGLE, 0});
+    if (t >= next_history_ms)
+    {
+      steps.push_back({t + 3000, REPLAY_MENU, 0, MENU_HISTORY});
+      steps.push_back({t + 6000, REPLAY_MENU, 0, MENU_NONE});
+      t += 6000;
+      next_history_ms += 15 * 60000;
+    }
+  }
+  steps.push_back({t + 2 * GROUPER_WINDOW, REPLAY_TICK, 0, 0}); // let the last group commit
+  return steps;
+}
+
+static void print_history(const char *name, const EventGrouper &grouper)
+{
+  const HistoryLog &log = grouper.getHistoryLog();
+  printf("[replay_run] %s: life %d, %u events in %u bytes\n", name, grouper.getLifeTotal(), (unsigned)log.size(), (unsigned)log.byteSize());
+  HistoryCursor cursor = log.cursor();
+  LifeHistoryEvent evt;
+  while (cursor.next(evt))
+    printf("  %+d @%02d:%02d [%d]\n", evt.net_life_change, evt.change_timestamp / 60, evt.change_timestamp % 60, evt.life_total);
+}
+
+ReplayReport replay_run(const std::vector<ReplayStep> &steps, bool verbose)
+{
+  ReplayReport report = {};
+  uint32_t wall_start = millis();
+  game_stash_save();
+  journal_pause(true);
+  reset_life();
+  reset_life_2p();
+  virtual_start_ms = millis();
+  virtual_now = 0;
+  game_clock_override(replay_clock_ms, replay_clock_seconds);
+
+  size_t tenth = steps.size() / 10;
+  uint64_t first_render_us = 0;
+  uint64_t last_render_us = 0;
+  for (size_t i = 0; i < steps.size(); ++i)
+  {
+    const ReplayStep &step = steps[i];
+    advance_to(step.at_ms, report);
+
+    uint32_t start_us = micros();
+    apply_step(step);
+    uint32_t action_us = micros() - start_us;
+    timing_add(report.action, action_us);
+
+    start_us = micros();
+    life_model_flush();
+    lv_refr_now(NULL);
+    uint32_t render_us = micros() - start_us;
+    timing_add(report.render, render_us);
+    if (i < tenth)
+      first_render_us += render_us;
+    else if (i >= steps.size() - tenth)
+      last_render_us += render_us;
+
+    if (verbose)
+      printf("[replay_run] %u ms %s %d %d: action %u us, render %u us\n", (unsigned)step.at_ms, op_names[step.op],
+             step.player, step.value, (unsigned)action_us, (unsigned)render_us);
+  }
+  report.steps = steps.size();
+  report.virtual_ms = virtual_now;
+  report.render_first_avg_us = tenth ? (uint32_t)(first_render_us / tenth) : 0;
+  report.render_last_avg_us = tenth ? (uint32_t)(last_render_us / tenth) : 0;
+
+  game_clock_override(nullptr, nullptr);
+  report.wall_ms = millis() - wall_start;
+
+  printf("[replay_run] %u steps, %u s of game in %u ms\n", (unsigned)report.steps, (unsigned)(report.virtual_ms / 1000), (unsigned)report.wall_ms);
+  printf("[replay_run] action avg %u us max %u us, commit avg %u us max %u us (%u commits)\n",
+         (unsigned)timing_avg(report.action), (unsigned)report.action.max_us,
+         (unsigned)timing_avg(report.commit), (unsigned)report.commit.max_us, (unsigned)report.commit.count);
+  printf("[replay_run] render avg %u us max %u us, first tenth %u us, last tenth %u us\n",
+         (unsigned)timing_avg(report.render), (unsigned)report.render.max_us,
+         (unsigned)report.render_first_avg_us, (unsigned)report.render_last_avg_us);
+  if (life_counter_mode == PLAYER_MODE_ONE_PLAYER)
+  {
+    if (verbose)
+      print_history("P", event_grouper);
+    else
+      printf("[replay_run] P: life %d, %u events\n", event_grouper.getLifeTotal(), (unsigned)event_grouper.getHistoryLog().size());
+  }
+  else
+  {
+    if (verbose)
+    {
+      print_history("P1", event_grouper_p1);
+      print_history("P2", event_grouper_p2);
+    }
+    else
+      printf("[replay_run] P1: life %d, P2: life %d, %u events\n", event_grouper_p1.getLifeTotal(), event_grouper_p2.getLifeTotal(),
+             (unsigned)(event_grouper_p1.getHistoryLog().size() + event_grouper_p2.getHistoryLog().size()));
+  }
+
+  // Hand the game from before the run back before the journal records again
+  renderMenu(MENU_NONE, false);
+  game_stash_restore();
+  journal_pause(false);
+  return report;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "constants/constants.h"
+
+// Deterministic game replay. A recorded list of steps (life changes, undos,
+// resets, menu actions) is pushed through the real queue_life_change /
+// EventGrouper / life model / LVGL render path on a virtual clock, so a field
+// bug report or a 3-hour game runs in seconds. The clock only advances between
+// steps, so the same script always produces the same history.
+//
+// A run takes over the counters with the journal paused. The final state is
+// reported (verbose prints the histories), then the game from before the run
+// is put back.
+
+#define REPLAY_STEP_MS 10 // virtual loop period while a group waits to commit
+
+// Dev builds: -DREPLAY_BENCH_MINUTES=180 replays a synthetic game of that length
+// once after boot and prints the report
+#ifndef REPLAY_BENCH_MINUTES
+#define REPLAY_BENCH_MINUTES 0
+#endif
+#define REPLAY_BENCH_DELAY_MS 10000 // let the boot sweep finish first
+
+enum ReplayOp : uint8_t
+{
+  REPLAY_LIFE,  // queue value for player (PLAYER_SINGLE/ONE/TWO)
+  REPLAY_UNDO,  // 1P undo
+  REPLAY_RESET, // reset the active counter
+  REPLAY_MODE,  // switch to PlayerMode value
+  REPLAY_MENU,  // open MenuState value (MENU_NONE closes)
+  REPLAY_TICK   // only advance the clock
+};
+
+struct ReplayStep
+{
+  uint32_t at_ms; // virtual time since the start of the run
+  ReplayOp op;
+  int8_t player;
+  int16_t value;
+};
+
+struct ReplayTiming
+{
+  uint32_t count;
+  uint64_t total_us;
+  uint32_t max_us;
+};
+
+struct ReplayReport
+{
+  uint32_t steps;
+  uint32_t virtual_ms;
+  uint32_t wall_ms;
+  ReplayTiming action;  // queue_life_change and friends
+  ReplayTiming commit;  // grouper window expiry to committed event
+  ReplayTiming render;  // model flush plus a full lv_refr_now
+  uint32_t render_first_avg_us; // first and last tenth of the run, to spot slowdowns
+  uint32_t render_last_avg_us;
+};
+
+// One step per line: "<ms> <op> [player] [value]" with op one of
+// life, undo, reset, mode, menu, tick. Blank lines and '#' comments are skipped.
+bool replay_parse(const char *script, std::vector<ReplayStep> &steps);
+// Synthetic game for `mode`: bursts of taps every few seconds, the odd undo and a
+// look at the history now and then, for `minutes` of game time
+std::vector<ReplayStep> replay_generate_game(uint32_t minutes, uint32_t seed, PlayerMode mode);
+// Runs the steps on the GUI task; verbose prints every step and the final history
+ReplayReport replay_run(const std::vector<ReplayStep> &steps, bool verbose = false);
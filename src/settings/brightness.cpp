@@ -3,9 +3,9 @@
 #include "state/state_store.h"
 #include "constants/constants.h"
 #include <menu/menu.h>
-#include <esp_display_panel.hpp>
+#include "helpers/backlight.h"
+#include "theme/theme.h"
 
-extern esp_panel::board::Board *board;
 extern lv_obj_t *brightness_control;
 
 struct ChangeData
@@ -15,15 +15,12 @@ struct ChangeData
 };
 
 int brightness = player_store.getInt(KEY_BRIGHTNESS, 100); // Default to 100% if not set
+static lv_obj_t *brightness_value_label = nullptr;
 
 static void set_brightness()
 {
   player_store.putInt(KEY_BRIGHTNESS, brightness);
-  bool success = board->getBacklight()->setBrightness(brightness);
-  if (!success)
-  {
-    printf("Failed to set brightness\n");
-  }
+  backlight_set_level(brightness);
 }
 
 static void brightness_up_event_handler(lv_event_t *e)
@@ -61,20 +58,16 @@ void teardownBrightnessOverlay()
     lv_obj_del(brightness_control);
     brightness_control = nullptr;
   }
+  brightness_value_label = nullptr;
 }
 
-void renderBrightnessOverlay()
+// Build the brightness overlay widget tree once; the value is filled in on show
+static void buildBrightnessOverlay()
 {
-
-  teardownBrightnessOverlay();
   brightness_control = lv_obj_create(lv_scr_act());
   lv_obj_set_size(brightness_control, SCREEN_WIDTH, SCREEN_HEIGHT);
-  lv_obj_set_style_bg_color(brightness_control, BLACK_COLOR, LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(brightness_control, LV_OPA_COVER, LV_PART_MAIN);
-  lv_obj_set_style_radius(brightness_control, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-  lv_obj_set_style_border_opa(brightness_control, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_outline_opa(brightness_control, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(brightness_control, 16, LV_PART_MAIN);
+  lv_obj_add_style(brightness_control, &style_round_overlay, LV_PART_MAIN);
+  lv_obj_add_style(brightness_control, &style_overlay_padded, LV_PART_MAIN);
 
   // Define grid: 3 columns, 3 rows
   static lv_coord_t col_dsc[] = {LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
@@ -85,27 +78,24 @@ void renderBrightnessOverlay()
   // Add back button
   lv_obj_t *btn_back = lv_btn_create(brightness_control);
   lv_obj_set_size(btn_back, 100, 60);
-  lv_obj_set_style_bg_color(btn_back, lv_color_white(), LV_PART_MAIN);
+  lv_obj_add_style(btn_back, &style_back_button, LV_PART_MAIN);
   lv_obj_set_grid_cell(btn_back, LV_GRID_ALIGN_CENTER, 0, 3, LV_GRID_ALIGN_START, 0, 1);
   lv_obj_t *lbl_back = lv_label_create(btn_back);
   lv_label_set_text(lbl_back, LV_SYMBOL_LEFT " Back");
-  lv_obj_set_style_text_font(lbl_back, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_back, &style_back_label, 0);
   lv_obj_center(lbl_back);
-  lv_obj_set_style_text_color(lbl_back, lv_color_black(), 0);
   lv_obj_add_event_cb(btn_back, [](lv_event_t *e)
                       { renderMenu(MENU_SETTINGS); }, LV_EVENT_CLICKED, NULL);
 
   // Top label
   lv_obj_t *label = lv_label_create(brightness_control);
   lv_label_set_text(label, "Brightness");
-  lv_obj_set_style_text_font(label, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(label, &style_button_label, 0);
   lv_obj_set_grid_cell(label, LV_GRID_ALIGN_CENTER, 0, 3, LV_GRID_ALIGN_CENTER, 1, 1);
 
   // Brightness value label
   lv_obj_t *value_label = lv_label_create(brightness_control);
-  char buf[8];
-  snprintf(buf, sizeof(buf), "%d", brightness);
-  lv_label_set_text(value_label, buf);
+  brightness_value_label = value_label;
   lv_obj_set_style_text_font(value_label, &lv_font_montserrat_36, 0);
   lv_obj_set_grid_cell(value_label, LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_CENTER, 2, 1);
 
@@ -127,3 +117,14 @@ void renderBrightnessOverlay()
   lv_obj_center(right_label);
   lv_obj_add_event_cb(btn_right, brightness_up_event_handler, LV_EVENT_CLICKED, value_label);
 }
+
+// Show the brightness overlay, building it on first use
+void renderBrightnessOverlay()
+{
+  if (!brightness_control)
+    buildBrightnessOverlay();
+  char buf[8];
+  snprintf(buf, sizeof(buf), "%d", brightness);
+  lv_label_set_text(brightness_value_label, buf);
+  lv_obj_clear_flag(brightness_control, LV_OBJ_FLAG_HIDDEN);
+}
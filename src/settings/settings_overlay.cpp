@@ -2,35 +2,64 @@
 #include "constants/constants.h"
 #include "battery/battery_state.h"
 #include "menu/menu.h"
+#include "theme/theme.h"
 #include <lvgl.h>
 #include <state/state_store.h>
 #include <life/life_counter.h>
 #include <life/life_counter2P.h>
 #include <helpers/animation_helpers.h>
 #include <timer/timer.h>
+#include <log/log.h>
 
 extern lv_obj_t *settings_menu;
 extern lv_obj_t *life_counter_container;
 extern lv_obj_t *life_counter_container_2p;
 
+// Widgets whose content changes between opens
+static lv_obj_t *btn_amp_toggle = nullptr;
+static lv_obj_t *btn_timer_toggle = nullptr;
+static lv_obj_t *lbl_batt = nullptr;
+
+// Fixed reading shown while pinned, so the frame does not depend on the battery
+#define PINNED_BATTERY_PERCENT 100
+#define PINNED_BATTERY_VOLTS 4.20f
+static bool battery_pinned = false;
+
 // Use a static callback instead of a lambda
 static void btn_life_event_cb(lv_event_t *e)
 {
   renderMenu(MENU_LIFE_CONFIG);
 }
 
-// Draw settings overlay using LVGL
-void renderSettingsOverlay()
+// Battery percentage subject -> battery label
+static void battery_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  int pct = battery_pinned ? PINNED_BATTERY_PERCENT : lv_subject_get_int(subject);
+  float volts = battery_pinned ? PINNED_BATTERY_VOLTS : battery_get_volts();
+  LOG_D(UI, "[Settings] Battery: %.2fV, %d%%\n", volts, pct);
+  char batt_str[32];
+  const char *bat_symbol = (pct < 15) ? LV_SYMBOL_BATTERY_EMPTY : (pct < 30) ? LV_SYMBOL_BATTERY_1
+                                                              : (pct < 55)   ? LV_SYMBOL_BATTERY_2
+                                                              : (pct < 80)   ? LV_SYMBOL_BATTERY_3
+                                                                             : LV_SYMBOL_BATTERY_FULL;
+  snprintf(batt_str, sizeof(batt_str), "%s %d%% (%.2fV)", bat_symbol, pct, volts);
+  lv_label_set_text(lv_observer_get_target_obj(observer), batt_str);
+}
+
+void pinSettingsBattery(bool pinned)
+{
+  battery_pinned = pinned;
+  if (lbl_batt)
+    lv_subject_notify(battery_subject_percent());
+}
+
+// Build the settings overlay widget tree once; values are filled in by refreshSettingsOverlay
+static void buildSettingsOverlay()
 {
-  teardownSettingsOverlay();
   settings_menu = lv_obj_create(lv_scr_act());
   lv_obj_set_size(settings_menu, SCREEN_WIDTH, SCREEN_HEIGHT);
-  lv_obj_set_style_bg_color(settings_menu, BLACK_COLOR, LV_PART_MAIN); // dark background
-  lv_obj_set_style_bg_opa(settings_menu, LV_OPA_COVER, LV_PART_MAIN);
-  lv_obj_set_style_border_opa(settings_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_outline_opa(settings_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_radius(settings_menu, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(settings_menu, 16, LV_PART_MAIN);
+  lv_obj_add_style(settings_menu, &style_round_overlay, LV_PART_MAIN);
+  lv_obj_add_style(settings_menu, &style_overlay_padded, LV_PART_MAIN);
 
   // Define grid: 9 rows, 1 column
   // Center the layout by using a single column and adjusting alignment
@@ -43,13 +72,12 @@ void renderSettingsOverlay()
   // Back button
   lv_obj_t *btn_back = lv_btn_create(settings_menu);
   lv_obj_set_size(btn_back, 100, 60);
-  lv_obj_set_style_bg_color(btn_back, lv_color_white(), LV_PART_MAIN);
+  lv_obj_add_style(btn_back, &style_back_button, LV_PART_MAIN);
   lv_obj_set_grid_cell(btn_back, LV_GRID_ALIGN_CENTER, 0, 2, LV_GRID_ALIGN_START, 0, 1);
   lv_obj_t *lbl_back = lv_label_create(btn_back);
   lv_label_set_text(lbl_back, LV_SYMBOL_LEFT " Back");
-  lv_obj_set_style_text_font(lbl_back, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_back, &style_back_label, 0);
   lv_obj_center(lbl_back);
-  lv_obj_set_style_text_color(lbl_back, lv_color_black(), 0);
   lv_obj_add_event_cb(btn_back, [](lv_event_t *e)
                       { renderMenu(MENU_CONTEXTUAL, false); }, LV_EVENT_CLICKED, NULL);
 
@@ -60,7 +88,7 @@ void renderSettingsOverlay()
   lv_obj_set_grid_cell(btn_life, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_START, 1, 1);
   lv_obj_t *lbl_life = lv_label_create(btn_life);
   lv_label_set_text(lbl_life, "Start Life");
-  lv_obj_set_style_text_font(lbl_life, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_life, &style_button_label, 0);
   lv_obj_center(lbl_life);
   lv_obj_add_event_cb(btn_life, btn_life_event_cb, LV_EVENT_CLICKED, NULL);
 
@@ -74,18 +102,15 @@ void renderSettingsOverlay()
                       { renderMenu(MENU_BRIGHTNESS); }, LV_EVENT_CLICKED, NULL);
   lv_obj_t *lbl_brightness = lv_label_create(btn_brightness);
   lv_label_set_text(lbl_brightness, "Brightness");
-  lv_obj_set_style_text_font(lbl_brightness, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_brightness, &style_button_label, 0);
   lv_obj_center(lbl_brightness);
 
   // Amp Counter
-  int amp_mode = player_store.getInt(KEY_AMP_MODE, 0);
-  lv_obj_t *btn_amp_toggle = lv_btn_create(settings_menu);
-  lv_obj_set_style_bg_color(btn_amp_toggle, (amp_mode ? LIGHTNING_BLUE_COLOR : GRAY_COLOR), LV_PART_MAIN);
+  btn_amp_toggle = lv_btn_create(settings_menu);
   lv_obj_set_size(btn_amp_toggle, 120, 50);
   lv_obj_set_grid_cell(btn_amp_toggle, LV_GRID_ALIGN_CENTER, 0, 1, LV_GRID_ALIGN_START, 2, 1);
   lv_obj_t *lbl_amp_label = lv_label_create(btn_amp_toggle);
-  lv_label_set_text(lbl_amp_label, (amp_mode ? "Amp On" : "Amp Off")); // shows current state
-  lv_obj_set_style_text_font(lbl_amp_label, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_amp_label, &style_button_label, 0);
   lv_obj_center(lbl_amp_label);
   // Store the label pointer as user data for the callback
   lv_obj_add_event_cb(btn_amp_toggle, [](lv_event_t *e)
@@ -111,14 +136,11 @@ void renderSettingsOverlay()
     } }, LV_EVENT_CLICKED, NULL);
 
   // Timer Toggle button
-  lv_obj_t *btn_timer_toggle = lv_btn_create(settings_menu);
+  btn_timer_toggle = lv_btn_create(settings_menu);
   lv_obj_set_size(btn_timer_toggle, 120, 50);
-  lv_obj_set_style_bg_color(btn_timer_toggle, (player_store.getInt(KEY_SHOW_TIMER, 1) ? LIGHTNING_BLUE_COLOR : GRAY_COLOR), LV_PART_MAIN);
   lv_obj_set_grid_cell(btn_timer_toggle, LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_START, 2, 1);
   lv_obj_t *lbl_timer = lv_label_create(btn_timer_toggle);
-  uint64_t show_timer = player_store.getInt(KEY_SHOW_TIMER, 0);
-  lv_label_set_text(lbl_timer, (show_timer ? "Timer On" : "Timer Off"));
-  lv_obj_set_style_text_font(lbl_timer, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_timer, &style_button_label, 0);
   lv_obj_center(lbl_timer);
   lv_obj_add_event_cb(btn_timer_toggle, [](lv_event_t *e)
                       { 
@@ -139,7 +161,7 @@ void renderSettingsOverlay()
                             life_counter_container : life_counter_container_2p;
                           if (!active_counter)
                           {
-                            printf("[renderSettingsOverlay] No active life counter found, cannot render timer\n");
+                            LOG_W(UI, "[renderSettingsOverlay] No active life counter found, cannot render timer\n");
                             return;
                           }
                           // Render the timer overlay on the active life counter
@@ -159,25 +181,39 @@ void renderSettingsOverlay()
   lv_obj_set_grid_cell(btn_restart, LV_GRID_ALIGN_CENTER, 0, 2, LV_GRID_ALIGN_END, 3, 1);
   lv_obj_t *lbl_restart = lv_label_create(btn_restart);
   lv_label_set_text(lbl_restart, "Reboot");
-  lv_obj_set_style_text_font(lbl_restart, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_restart, &style_button_label, 0);
   lv_obj_center(lbl_restart);
   lv_obj_add_event_cb(btn_restart, [](lv_event_t *e)
-                      { esp_restart(); }, LV_EVENT_CLICKED, NULL);
+                      { log_flush(); esp_restart(); }, LV_EVENT_CLICKED, NULL);
 
   // Battery
-  lv_obj_t *lbl_batt = lv_label_create(settings_menu);
-  float pct = battery_get_percent();
-  float volts = battery_get_volts();
-  printf("[Settings] Battery: %.2fV, %.1f%%\n", volts, pct);
-  char batt_str[32];
-  const char *bat_symbol = (pct < 15) ? LV_SYMBOL_BATTERY_EMPTY : (pct < 30) ? LV_SYMBOL_BATTERY_1
-                                                              : (pct < 55)   ? LV_SYMBOL_BATTERY_2
-                                                              : (pct < 80)   ? LV_SYMBOL_BATTERY_3
-                                                                             : LV_SYMBOL_BATTERY_FULL;
-  snprintf(batt_str, sizeof(batt_str), "%s %d%% (%.2fV)", bat_symbol, (int)(pct + 0.5f), volts);
-  lv_label_set_text(lbl_batt, batt_str);
-  lv_obj_set_style_text_font(lbl_batt, &lv_font_montserrat_20, 0);
+  lbl_batt = lv_label_create(settings_menu);
+  lv_obj_add_style(lbl_batt, &style_button_label, 0);
   lv_obj_set_grid_cell(lbl_batt, LV_GRID_ALIGN_CENTER, 0, 2, LV_GRID_ALIGN_CENTER, 4, 1);
+  lv_subject_add_observer_obj(battery_subject_percent(), battery_observer_cb, lbl_batt, NULL);
+}
+
+// Push the current amp and timer settings into the retained widgets
+static void refreshSettingsOverlay()
+{
+  int amp_mode = player_store.getInt(KEY_AMP_MODE, 0);
+  lv_obj_set_style_bg_color(btn_amp_toggle, (amp_mode ? LIGHTNING_BLUE_COLOR : GRAY_COLOR), LV_PART_MAIN);
+  lv_label_set_text(lv_obj_get_child(btn_amp_toggle, 0), (amp_mode ? "Amp On" : "Amp Off")); // shows current state
+
+  uint64_t show_timer = player_store.getInt(KEY_SHOW_TIMER, 0);
+  lv_obj_set_style_bg_color(btn_timer_toggle, (player_store.getInt(KEY_SHOW_TIMER, 1) ? LIGHTNING_BLUE_COLOR : GRAY_COLOR), LV_PART_MAIN);
+  lv_label_set_text(lv_obj_get_child(btn_timer_toggle, 0), (show_timer ? "Timer On" : "Timer Off"));
+
+  battery_subject_update(); // the label follows the subject from here on
+}
+
+// Show the settings overlay, building it on first use
+void renderSettingsOverlay()
+{
+  if (!settings_menu)
+    buildSettingsOverlay();
+  refreshSettingsOverlay();
+  lv_obj_clear_flag(settings_menu, LV_OBJ_FLAG_HIDDEN);
 }
 
 void teardownSettingsOverlay()
@@ -187,4 +223,7 @@ void teardownSettingsOverlay()
     lv_obj_del(settings_menu);
     settings_menu = nullptr;
   }
+  btn_amp_toggle = nullptr;
+  btn_timer_toggle = nullptr;
+  lbl_batt = nullptr;
 }
\ No newline at end of file
@@ -4,4 +4,6 @@ extern "C"
   void renderSettingsOverlay();
   void showStartLifeScreen();
   void teardownSettingsOverlay();
+  // Show a fixed battery reading instead of the live one (render check)
+  void pinSettingsBattery(bool pinned);
 }
\ No newline at end of file
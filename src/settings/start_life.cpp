@@ -4,12 +4,10 @@
 #include "state/state_store.h"
 #include <life/life_counter.h>
 #include <life/life_counter2P.h>
+#include <theme/theme.h>
+#include <log/log.h>
 
 extern lv_obj_t *life_config_menu;
-int max_life;
-int small_step;
-int large_step;
-
 // Shared input state struct
 struct SharedInputState
 {
@@ -19,6 +17,16 @@ struct SharedInputState
   lv_obj_t *current_label;
 };
 
+int max_life;
+int small_step;
+int large_step;
+
+// Value labels and shared input widgets refreshed on every open
+static lv_obj_t *lbl_max_life_val = nullptr;
+static lv_obj_t *lbl_small_step_val = nullptr;
+static lv_obj_t *lbl_large_step_val = nullptr;
+static SharedInputState shared_input_state = {nullptr, nullptr, nullptr, nullptr};
+
 // Static event callback for value buttons
 void open_input_cb(lv_event_t *e)
 {
@@ -124,7 +132,7 @@ static const lv_buttonmatrix_ctrl_t kb_ctrl[] = {
 static void handle_save()
 {
   // add save logic here
-  printf("Save button clicked\n");
+  LOG_D(UI, "Save button clicked\n");
   player_store.putInt(KEY_LIFE_MAX, max_life);
   player_store.putInt(KEY_LIFE_STEP_SMALL, small_step);
   player_store.putInt(KEY_LIFE_STEP_LARGE, large_step);
@@ -140,22 +148,14 @@ static void handle_save()
   renderMenu(MENU_SETTINGS);
 }
 
-void renderLifeConfigScreen()
+// Build the life config widget tree once; values are filled in by refreshLifeConfigScreen
+static void buildLifeConfigScreen()
 {
-  teardownStartLifeScreen();
-  max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
-  small_step = player_store.getInt(KEY_LIFE_STEP_SMALL, DEFAULT_LIFE_INCREMENT_SMALL);
-  large_step = player_store.getInt(KEY_LIFE_STEP_LARGE, DEFAULT_LIFE_INCREMENT_LARGE);
-
   // Create the main menu object
   life_config_menu = lv_obj_create(lv_scr_act());
   lv_obj_set_size(life_config_menu, SCREEN_WIDTH, SCREEN_HEIGHT);
-  lv_obj_set_style_bg_color(life_config_menu, BLACK_COLOR, LV_PART_MAIN); // dark background
-  lv_obj_set_style_bg_opa(life_config_menu, LV_OPA_COVER, LV_PART_MAIN);
-  lv_obj_set_style_border_opa(life_config_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_outline_opa(life_config_menu, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_radius(life_config_menu, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(life_config_menu, 16, LV_PART_MAIN);
+  lv_obj_add_style(life_config_menu, &style_round_overlay, LV_PART_MAIN);
+  lv_obj_add_style(life_config_menu, &style_overlay_padded, LV_PART_MAIN);
 
   // Define grid: 5 rows, 1 column
   static lv_coord_t col_dsc[] = {LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
@@ -166,13 +166,12 @@ void renderLifeConfigScreen()
   // Back button
   lv_obj_t *btn_back = lv_btn_create(life_config_menu);
   lv_obj_set_size(btn_back, 100, 60);
-  lv_obj_set_style_bg_color(btn_back, lv_color_white(), LV_PART_MAIN);
+  lv_obj_add_style(btn_back, &style_back_button, LV_PART_MAIN);
   lv_obj_set_grid_cell(btn_back, LV_GRID_ALIGN_CENTER, 0, 2, LV_GRID_ALIGN_START, 0, 1);
   lv_obj_t *lbl_back = lv_label_create(btn_back);
   lv_label_set_text(lbl_back, LV_SYMBOL_LEFT " Back");
-  lv_obj_set_style_text_font(lbl_back, &lv_font_montserrat_20, 0);
+  lv_obj_add_style(lbl_back, &style_back_label, 0);
   lv_obj_center(lbl_back);
-  lv_obj_set_style_text_color(lbl_back, lv_color_black(), 0);
   lv_obj_add_event_cb(btn_back, [](lv_event_t *e)
                       { handle_save();
                         renderMenu(MENU_SETTINGS); }, LV_EVENT_CLICKED, NULL);
@@ -180,62 +179,50 @@ void renderLifeConfigScreen()
   // Life Max label
   lv_obj_t *lbl_life_max = lv_label_create(life_config_menu);
   lv_label_set_text(lbl_life_max, "Life Start");
-  lv_obj_set_style_text_font(lbl_life_max, &lv_font_montserrat_24, 0);
-  lv_obj_set_style_text_color(lbl_life_max, lv_color_white(), 0);
+  lv_obj_add_style(lbl_life_max, &style_value_label, 0);
   lv_obj_set_grid_cell(lbl_life_max, LV_GRID_ALIGN_END, 0, 1, LV_GRID_ALIGN_CENTER, 1, 1);
 
   // Life Max value button
   lv_obj_t *btn_max_life = lv_btn_create(life_config_menu);
   lv_obj_set_size(btn_max_life, 80, 40);
-  lv_obj_set_style_text_font(btn_max_life, &lv_font_montserrat_24, 0);
+  lv_obj_add_style(btn_max_life, &style_value_label, 0);
   lv_obj_set_grid_cell(btn_max_life, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 1, 1);
-  lv_obj_t *lbl_max_life_val = lv_label_create(btn_max_life);
-  char buf[16];
-  snprintf(buf, sizeof(buf), "%d", max_life);
-  lv_label_set_text(lbl_max_life_val, buf);
+  lbl_max_life_val = lv_label_create(btn_max_life);
   lv_obj_center(lbl_max_life_val);
 
   // Life Small Step label
   lv_obj_t *lbl_small_step = lv_label_create(life_config_menu);
   lv_label_set_text(lbl_small_step, "Small Step");
-  lv_obj_set_style_text_font(lbl_small_step, &lv_font_montserrat_24, 0);
-  lv_obj_set_style_text_color(lbl_small_step, lv_color_white(), 0);
+  lv_obj_add_style(lbl_small_step, &style_value_label, 0);
   lv_obj_set_grid_cell(lbl_small_step, LV_GRID_ALIGN_END, 0, 1, LV_GRID_ALIGN_CENTER, 2, 1);
 
   // Life Small Step value button
   lv_obj_t *btn_small_step = lv_btn_create(life_config_menu);
   lv_obj_set_size(btn_small_step, 80, 40);
-  lv_obj_set_style_text_font(btn_small_step, &lv_font_montserrat_24, 0);
+  lv_obj_add_style(btn_small_step, &style_value_label, 0);
   lv_obj_set_grid_cell(btn_small_step, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 2, 1);
-  lv_obj_t *lbl_small_step_val = lv_label_create(btn_small_step);
-  snprintf(buf, sizeof(buf), "%d", small_step);
-  lv_label_set_text(lbl_small_step_val, buf);
+  lbl_small_step_val = lv_label_create(btn_small_step);
   lv_obj_center(lbl_small_step_val);
 
   // Life Large Step label
   lv_obj_t *lbl_large_step = lv_label_create(life_config_menu);
   lv_label_set_text(lbl_large_step, "Big Step");
-  lv_obj_set_style_text_font(lbl_large_step, &lv_font_montserrat_24, 0);
-  lv_obj_set_style_text_color(lbl_large_step, lv_color_white(), 0);
+  lv_obj_add_style(lbl_large_step, &style_value_label, 0);
   lv_obj_set_grid_cell(lbl_large_step, LV_GRID_ALIGN_END, 0, 1, LV_GRID_ALIGN_CENTER, 3, 1);
 
   // Life Large Step value button
   lv_obj_t *btn_large_step = lv_btn_create(life_config_menu);
   lv_obj_set_size(btn_large_step, 80, 40);
-  lv_obj_set_style_text_font(btn_large_step, &lv_font_montserrat_24, 0);
+  lv_obj_add_style(btn_large_step, &style_value_label, 0);
   lv_obj_set_grid_cell(btn_large_step, LV_GRID_ALIGN_START, 1, 1, LV_GRID_ALIGN_CENTER, 3, 1);
-  lv_obj_t *lbl_large_step_val = lv_label_create(btn_large_step);
-  snprintf(buf, sizeof(buf), "%d", large_step);
-  lv_label_set_text(lbl_large_step_val, buf);
+  lbl_large_step_val = lv_label_create(btn_large_step);
   lv_obj_center(lbl_large_step_val);
-  static SharedInputState shared_input_state = {nullptr, nullptr, nullptr, nullptr};
 
   // Create shared text area and keyboard
   // Create shared text area above keyboard, not overlapping
   shared_input_state.ta = lv_textarea_create(life_config_menu);
   lv_textarea_set_one_line(shared_input_state.ta, true);
-  lv_obj_set_style_text_font(shared_input_state.ta, &lv_font_montserrat_24, 0);
-  lv_obj_set_style_text_color(shared_input_state.ta, lv_color_white(), 0);
+  lv_obj_add_style(shared_input_state.ta, &style_value_label, 0);
   lv_obj_set_size(shared_input_state.ta, SCREEN_WIDTH - 120, 50);
   lv_obj_align(shared_input_state.ta, LV_ALIGN_TOP_MID, 0, 30);
   lv_obj_add_flag(shared_input_state.ta, LV_OBJ_FLAG_HIDDEN);
@@ -262,6 +249,36 @@ void renderLifeConfigScreen()
   lv_obj_add_event_cb(shared_input_state.ta, shared_ta_event_cb, LV_EVENT_ALL, &shared_input_state);
 }
 
+// Reload the stored values and reset the shared input so every open starts clean
+static void refreshLifeConfigScreen()
+{
+  max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
+  small_step = player_store.getInt(KEY_LIFE_STEP_SMALL, DEFAULT_LIFE_INCREMENT_SMALL);
+  large_step = player_store.getInt(KEY_LIFE_STEP_LARGE, DEFAULT_LIFE_INCREMENT_LARGE);
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%d", max_life);
+  lv_label_set_text(lbl_max_life_val, buf);
+  snprintf(buf, sizeof(buf), "%d", small_step);
+  lv_label_set_text(lbl_small_step_val, buf);
+  snprintf(buf, sizeof(buf), "%d", large_step);
+  lv_label_set_text(lbl_large_step_val, buf);
+
+  lv_obj_add_flag(shared_input_state.ta, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_add_flag(shared_input_state.kb, LV_OBJ_FLAG_HIDDEN);
+  lv_keyboard_set_textarea(shared_input_state.kb, NULL);
+  shared_input_state.current_var = nullptr;
+  shared_input_state.current_label = nullptr;
+}
+
+// Show the life config screen, building it on first use
+void renderLifeConfigScreen()
+{
+  if (!life_config_menu)
+    buildLifeConfigScreen();
+  refreshLifeConfigScreen();
+  lv_obj_clear_flag(life_config_menu, LV_OBJ_FLAG_HIDDEN);
+}
+
 void teardownStartLifeScreen()
 {
   if (life_config_menu)
@@ -269,4 +286,8 @@ void teardownStartLifeScreen()
     lv_obj_del(life_config_menu);
     life_config_menu = nullptr;
   }
+  lbl_max_life_val = nullptr;
+  lbl_small_step_val = nullptr;
+  lbl_large_step_val = nullptr;
+  shared_input_state = {nullptr, nullptr, nullptr, nullptr};
 }
\ No newline at end of file
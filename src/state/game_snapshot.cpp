@@ -0,0 +1,185 @@
+#include "game_snapshot.h"
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <string.h>
+#include <vector>
+#include "constants/constants.h"
+#include "main.h"
+#include "state/life_model.h"
+#include "helpers/event_grouper.h"
+#include "helpers/varint.h"
+#include "life/life_counter.h"
+#include "life/life_counter2P.h"
+#include "timer/timer.h"
+#include "log/log.h"
+
+struct GameSnapshotHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length; // payload bytes
+  uint32_t crc;    // over the payload
+};
+
+#define GAME_SNAPSHOT_PAYLOAD (GAME_SNAPSHOT_BYTES - sizeof(GameSnapshotHeader))
+
+RTC_DATA_ATTR static GameSnapshotHeader rtc_header;
+RTC_DATA_ATTR static uint8_t rtc_payload[GAME_SNAPSHOT_PAYLOAD];
+
+// Histories are stored as deltas (life change, game-time and boot-time steps),
+// which are small, so zigzag varints keep most events at 3-4 bytes.
+
+struct SnapshotWriter
+{
+  uint8_t *buf;
+  size_t cap;
+  size_t len;
+  bool overflow;
+};
+
+static void put_uvarint(SnapshotWriter &w, uint32_t v)
+{
+  uint8_t tmp[VARINT_MAX_BYTES];
+  size_t n = varint_encode(tmp, v);
+  if (w.len + n > w.cap)
+  {
+    w.overflow = true;
+    return;
+  }
+  memcpy(w.buf + w.len, tmp, n);
+  w.len += n;
+}
+
+static void put_svarint(SnapshotWriter &w, int32_t v)
+{
+  put_uvarint(w, zigzag_encode(v));
+}
+
+// One grouper: committed total, then the newest events (skipping `skip` oldest)
+static void write_grouper(SnapshotWriter &w, EventGrouper &grouper, size_t skip)
+{
+  const HistoryLog &history = grouper.getHistoryLog();
+  if (skip > history.size())
+    skip = history.size();
+  put_svarint(w, grouper.getLifeTotal());
+  put_uvarint(w, history.size() - skip);
+  uint32_t prev_ts = 0;
+  int prev_change_ts = 0;
+  HistoryCursor cursor = history.cursor(skip);
+  LifeHistoryEvent evt;
+  while (!w.overflow && cursor.next(evt))
+  {
+    put_svarint(w, evt.net_life_change);
+    put_svarint(w, evt.change_timestamp - prev_change_ts);
+    put_uvarint(w, evt.timestamp - prev_ts);
+    prev_ts = evt.timestamp;
+    prev_change_ts = evt.change_timestamp;
+  }
+}
+
+static bool read_grouper(VarintReader &r, EventGrouper &grouper, int player_id)
+{
+  int life_total = varint_get_s(r);
+  uint32_t count = varint_get_u(r);
+  if (r.error || count > GAME_SNAPSHOT_PAYLOAD)
+    return false;
+  std::vector<LifeHistoryEvent> events;
+  events.reserve(count);
+  uint32_t ts = 0;
+  int change_ts = 0;
+  for (uint32_t i = 0; i < count && !r.error; ++i)
+  {
+    LifeHistoryEvent evt;
+    evt.net_life_change = varint_get_s(r);
+    change_ts += varint_get_s(r);
+    ts += varint_get_u(r);
+    evt.change_timestamp = change_ts;
+    evt.timestamp = ts;
+    evt.player_id = player_id;
+    events.push_back(evt);
+  }
+  if (r.error)
+    return false;
+  // Totals are implied: walk back from the committed total
+  int total = life_total;
+  for (size_t i = events.size(); i-- > 0;)
+  {
+    events[i].life_total = total;
+    total -= events[i].net_life_change;
+  }
+  grouper.restoreHistory(life_total, events);
+  return true;
+}
+
+static size_t encode(uint8_t *buf, size_t cap, size_t skip, bool *overflow)
+{
+  SnapshotWriter w = {buf, cap, 0, false};
+  put_uvarint(w, life_counter_mode);
+  put_uvarint(w, life_model_get_amp());
+  put_uvarint(w, get_elapsed_seconds());
+  put_uvarint(w, get_is_timer_running());
+  write_grouper(w, event_grouper, skip);
+  write_grouper(w, event_grouper_p1, skip);
+  write_grouper(w, event_grouper_p2, skip);
+  *overflow = w.overflow;
+  return w.len;
+}
+
+void game_snapshot_save(void)
+{
+  uint32_t start_us = micros();
+  // Fold pending taps into the history so nothing in the grouping window is lost
+  event_grouper.commitNow();
+  event_grouper_p1.commitNow();
+  event_grouper_p2.commitNow();
+
+  // Drop the oldest events until everything fits
+  size_t skip = 0;
+  size_t len = 0;
+  bool overflow = true;
+  while (overflow)
+  {
+    len = encode(rtc_payload, GAME_SNAPSHOT_PAYLOAD, skip, &overflow);
+    if (overflow)
+      skip += 8;
+  }
+  rtc_header.magic = GAME_SNAPSHOT_MAGIC;
+  rtc_header.version = GAME_SNAPSHOT_VERSION;
+  rtc_header.length = len;
+  rtc_header.crc = esp_rom_crc32_le(0, rtc_payload, len);
+  LOG_D(STATE, "[game_snapshot_save] %u bytes%s in %u us\n", (unsigned)len, skip ? " (oldest history dropped)" : "", (unsigned)(micros() - start_us));
+}
+
+bool game_snapshot_restore(void)
+{
+  if (rtc_header.magic != GAME_SNAPSHOT_MAGIC || rtc_header.version != GAME_SNAPSHOT_VERSION ||
+      rtc_header.length > GAME_SNAPSHOT_PAYLOAD ||
+      esp_rom_crc32_le(0, rtc_payload, rtc_header.length) != rtc_header.crc)
+    return false;
+
+  VarintReader r = {rtc_payload, rtc_header.length, 0, false};
+  PlayerMode mode = (PlayerMode)varint_get_u(r);
+  int amp = varint_get_u(r);
+  int elapsed = varint_get_u(r);
+  bool running = varint_get_u(r);
+  if (r.error ||
+      !read_grouper(r, event_grouper, PLAYER_SINGLE) ||
+      !read_grouper(r, event_grouper_p1, PLAYER_ONE) ||
+      !read_grouper(r, event_grouper_p2, PLAYER_TWO))
+  {
+    LOG_W(STATE, "[game_snapshot_restore] Corrupt snapshot, starting fresh\n");
+    game_snapshot_clear();
+    return false;
+  }
+  life_counter_mode = mode;
+  life_model_set_amp(amp);
+  restore_timer(elapsed, running);
+  LOG_I(STATE, "[game_snapshot_restore] Restored mode %d, %u bytes\n", mode, (unsigned)rtc_header.length);
+  return true;
+}
+
+void game_snapshot_clear(void)
+{
+  rtc_header.magic = 0;
+}
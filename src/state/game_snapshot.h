@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+// Game state kept in RTC slow memory across deep sleep: life totals, histories,
+// amp and stopwatch. Written right before esp_deep_sleep_start and checked with
+// a CRC on boot, so the counter can come back without the splash and sweep.
+
+#define GAME_SNAPSHOT_BYTES 2048 // RTC slow memory is 8KB on the S3
+#define GAME_SNAPSHOT_MAGIC 0x4C494645 // "LIFE"
+#define GAME_SNAPSHOT_VERSION 1
+
+void game_snapshot_save(void);
+// Restores the game into the groupers, life model and timer; false if there is
+// no valid snapshot. Sets life_counter_mode to the saved mode.
+bool game_snapshot_restore(void);
+void game_snapshot_clear(void);
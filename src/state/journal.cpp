@@ -0,0 +1,443 @@
+#include "journal.h"
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include <freertos/semphr.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "constants/constants.h"
+#include "main.h"
+#include "state/life_model.h"
+#include "state/state_store.h"
+#include "life/life_counter.h"
+#include "life/life_counter2P.h"
+#include "log/log.h"
+#include "replay/replay.h"
+#include "replay/game_stash.h"
+
+static const esp_partition_t *journal_partition = nullptr;
+static QueueHandle_t journal_queue = nullptr;
+static uint32_t page_count = 0;
+static uint32_t head_page = 0; // next page to write
+static uint32_t next_seq = 1;
+static bool journal_paused = false;
+static SemaphoreHandle_t journal_synced = nullptr;
+
+// A sector erase stops the flash cache on both cores for tens of ms, so the
+// writer erases the sector ahead of the head while the UI is idle and only
+// erases inline if the head gets there first. Writer task only.
+static int32_t erased_sector = -1;
+static volatile bool erase_requested = false;
+static uint32_t inline_erases = 0;
+static uint32_t inline_erase_max_us = 0;
+
+// Valid pages as (seq, page), oldest first. Built by journal_init's scan and used
+// by journal_replay, so a boot reads every page header once. It goes stale once
+// the writer appends, which is also when it is freed if no replay took it.
+static std::vector<std::pair<uint32_t, uint32_t>> valid_pages;
+
+static uint32_t page_crc(const JournalPageHeader &header, const JournalRecord *records)
+{
+  uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&header, offsetof(JournalPageHeader, crc));
+  return esp_rom_crc32_le(crc, (const uint8_t *)records, header.count * sizeof(JournalRecord));
+}
+
+static bool read_page(uint32_t page, JournalPageHeader &header, JournalRecord *records)
+{
+  size_t offset = page * JOURNAL_PAGE_SIZE;
+  if (esp_partition_read(journal_partition, offset, &header, sizeof(header)) != ESP_OK)
+    return false;
+  if (header.magic != JOURNAL_MAGIC || header.count == 0 || header.count > JOURNAL_RECORDS_PER_PAGE)
+    return false;
+  if (!records)
+    return true;
+  if (esp_partition_read(journal_partition, offset + sizeof(header), records, header.count * sizeof(JournalRecord)) != ESP_OK)
+    return false;
+  return page_crc(header, records) == header.crc;
+}
+
+static void scan_pages(void)
+{
+  valid_pages.clear();
+  for (uint32_t page = 0; page < page_count; ++page)
+  {
+    JournalPageHeader header;
+    if (read_page(page, header, nullptr))
+      valid_pages.push_back({header.seq, page});
+  }
+  std::sort(valid_pages.begin(), valid_pages.end());
+}
+
+// Only the writer task frees the index on its own, and it gets its first record
+// from the GUI task after journal_replay has run, so the two never overlap
+static void write_page(const JournalRecord *records, uint16_t count)
+{
+  if (!valid_pages.empty())
+    std::vector<std::pair<uint32_t, uint32_t>>().swap(valid_pages);
+  size_t offset = head_page * JOURNAL_PAGE_SIZE;
+  // Entering a new sector: erase it unless that was done ahead, which retires
+  // the oldest pages of the ring
+  if (offset % JOURNAL_SECTOR_SIZE == 0)
+  {
+    if ((int32_t)(offset / JOURNAL_SECTOR_SIZE) != erased_sector)
+    {
+      uint32_t start_us = micros();
+      esp_partition_erase_range(journal_partition, offset, JOURNAL_SECTOR_SIZE);
+      uint32_t erase_us = micros() - start_us;
+      inline_erases++;
+      inline_erase_max_us = std::max(inline_erase_max_us, erase_us);
+      LOG_D(STATE, "[journal] Inline sector erase, %u us\n", (unsigned)erase_us);
+    }
+    erased_sector = -1;
+  }
+
+  uint8_t page[JOURNAL_PAGE_SIZE];
+  memset(page, 0xFF, sizeof(page));
+  JournalPageHeader header = {JOURNAL_MAGIC, next_seq, count, 0xFFFF, 0};
+  header.crc = page_crc(header, records);
+  memcpy(page, &header, sizeof(header));
+  memcpy(page + sizeof(header), records, count * sizeof(JournalRecord));
+  esp_err_t err = esp_partition_write(journal_partition, offset, page, sizeof(header) + count * sizeof(JournalRecord));
+  if (err != ESP_OK)
+    LOG_E(STATE, "[journal] Page %u write failed: %s\n", (unsigned)head_page, esp_err_to_name(err));
+
+  next_seq++;
+  head_page = (head_page + 1) % page_count;
+}
+
+// Erases the sector the head enters next, if it is not erased yet
+static void erase_ahead(void)
+{
+  uint32_t sector_count = journal_partition->size / JOURNAL_SECTOR_SIZE;
+  uint32_t sector = (head_page * JOURNAL_PAGE_SIZE + JOURNAL_SECTOR_SIZE - 1) / JOURNAL_SECTOR_SIZE % sector_count;
+  if ((int32_t)sector == erased_sector)
+    return;
+  esp_partition_erase_range(journal_partition, sector * JOURNAL_SECTOR_SIZE, JOURNAL_SECTOR_SIZE);
+  erased_sector = sector;
+}
+
+// Batches queued records into pages: a full page is written at once, a partial one
+// after JOURNAL_FLUSH_MS without new records
+static void journal_task(void *pvParameters)
+{
+  JournalRecord records[JOURNAL_RECORDS_PER_PAGE];
+  uint16_t count = 0;
+  while (true)
+  {
+    JournalRecord rec;
+    TickType_t wait = count ? pdMS_TO_TICKS(JOURNAL_FLUSH_MS) : portMAX_DELAY;
+    bool sync = false;
+    if (xQueueReceive(journal_queue, &rec, wait) == pdTRUE)
+    {
+      if (rec.type == JOURNAL_ERASE_AHEAD)
+      {
+        erase_ahead();
+        erase_requested = false;
+        continue;
+      }
+      sync = (rec.type == JOURNAL_SYNC);
+      if (!sync)
+        records[count++] = rec;
+      if (!sync && count < JOURNAL_RECORDS_PER_PAGE)
+        continue;
+    }
+    if (count)
+    {
+      write_page(records, count);
+      count = 0;
+    }
+    if (sync)
+      xSemaphoreGive(journal_synced);
+  }
+}
+
+void journal_init(void)
+{
+  journal_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, JOURNAL_PARTITION_LABEL);
+  if (!journal_partition)
+  {
+    LOG_W(STATE, "[journal_init] No '%s' partition, journal disabled\n", JOURNAL_PARTITION_LABEL);
+    return;
+  }
+  page_count = journal_partition->size / JOURNAL_PAGE_SIZE;
+
+  // The newest valid page decides where writing continues
+  scan_pages();
+  next_seq = 1;
+  if (!valid_pages.empty())
+  {
+    next_seq = valid_pages.back().first + 1;
+    head_page = (valid_pages.back().second + 1) % page_count;
+  }
+  // Never append into a sector that already holds data from an older lap
+  if ((head_page * JOURNAL_PAGE_SIZE) % JOURNAL_SECTOR_SIZE != 0)
+  {
+    JournalPageHeader header;
+    esp_partition_read(journal_partition, head_page * JOURNAL_PAGE_SIZE, &header, sizeof(header));
+    if (header.magic != 0xFFFFFFFF)
+      head_page = ((head_page * JOURNAL_PAGE_SIZE / JOURNAL_SECTOR_SIZE + 1) * JOURNAL_SECTOR_SIZE / JOURNAL_PAGE_SIZE) % page_count;
+  }
+
+  journal_queue = xQueueCreate(JOURNAL_QUEUE_LEN, sizeof(JournalRecord));
+  journal_synced = xSemaphoreCreateBinary();
+  create_task(journal_task, "journal_task", 4096, NULL, 1);
+  LOG_I(STATE, "[journal_init] %u pages, next page %u, seq %u\n", (unsigned)page_count, (unsigned)head_page, (unsigned)next_seq);
+}
+
+static void journal_queue_record(const JournalRecord &rec)
+{
+  if (!journal_queue || journal_paused)
+    return;
+  if (xQueueSend(journal_queue, &rec, 0) != pdTRUE)
+    LOG_W(STATE, "[journal] Queue full, record dropped\n");
+}
+
+bool journal_sync(uint32_t timeout_ms)
+{
+  if (!journal_queue)
+    return false;
+  JournalRecord rec = {JOURNAL_SYNC, 0, 0, 0, 0xFFFF, 0, 0};
+  TickType_t start = xTaskGetTickCount();
+  xSemaphoreTake(journal_synced, 0); // drop a give left by a sync that timed out
+  if (xQueueSend(journal_queue, &rec, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+    return false;
+  TickType_t spent = xTaskGetTickCount() - start;
+  TickType_t left = pdMS_TO_TICKS(timeout_ms) > spent ? pdMS_TO_TICKS(timeout_ms) - spent : 0;
+  return xSemaphoreTake(journal_synced, left) == pdTRUE;
+}
+
+void journal_erase_ahead(void)
+{
+  if (!journal_queue || erase_requested)
+    return;
+  JournalRecord rec = {JOURNAL_ERASE_AHEAD, 0, 0, 0, 0xFFFF, 0, 0};
+  erase_requested = (xQueueSend(journal_queue, &rec, 0) == pdTRUE);
+}
+
+void journal_pause(bool paused)
+{
+  journal_paused = paused;
+}
+
+void journal_append(const LifeHistoryEvent &evt)
+{
+  JournalRecord rec = {JOURNAL_EVENT, (uint8_t)evt.player_id, (int16_t)evt.net_life_change, (int16_t)evt.life_total, 0xFFFF, evt.timestamp, evt.change_timestamp};
+  journal_queue_record(rec);
+}
+
+void journal_reset(int player_id, int base_life)
+{
+  JournalRecord rec = {JOURNAL_RESET, (uint8_t)player_id, 0, (int16_t)base_life, 0xFFFF, 0, 0};
+  journal_queue_record(rec);
+}
+
+void journal_undo(int player_id)
+{
+  JournalRecord rec = {JOURNAL_UNDO, (uint8_t)player_id, 0, 0, 0xFFFF, 0, 0};
+  journal_queue_record(rec);
+}
+
+bool journal_replay(void)
+{
+  if (!journal_partition)
+    return false;
+  uint32_t start_us = micros();
+
+  // Walk the pages journal_init found, oldest first
+  std::vector<std::pair<uint32_t, uint32_t>> pages;
+  pages.swap(valid_pages);
+
+  EventGrouper *groupers[LIFE_MODEL_PLAYERS] = {&event_grouper, &event_grouper_p1, &event_grouper_p2};
+  std::vector<LifeHistoryEvent> events[LIFE_MODEL_PLAYERS];
+  int totals[LIFE_MODEL_PLAYERS] = {0, 0, 0};
+  bool seen[LIFE_MODEL_PLAYERS] = {false, false, false};
+  uint32_t record_count = 0;
+  JournalRecord records[JOURNAL_RECORDS_PER_PAGE];
+  for (const auto &entry : pages)
+  {
+    JournalPageHeader header;
+    if (!read_page(entry.second, header, records))
+      continue; // torn or corrupt page, skip it
+    for (uint16_t i = 0; i < header.count; ++i)
+    {
+      const JournalRecord &rec = records[i];
+      if (rec.player_id >= LIFE_MODEL_PLAYERS)
+        continue;
+      seen[rec.player_id] = true;
+      if (rec.type == JOURNAL_RESET)
+      {
+        events[rec.player_id].clear();
+        totals[rec.player_id] = rec.life_total;
+      }
+      else if (rec.type == JOURNAL_EVENT)
+      {
+        events[rec.player_id].push_back({rec.net_life_change, rec.life_total, rec.player_id, rec.timestamp, rec.change_timestamp});
+        totals[rec.player_id] = rec.life_total;
+      }
+      else if (rec.type == JOURNAL_UNDO && !events[rec.player_id].empty())
+      {
+        totals[rec.player_id] -= events[rec.player_id].back().net_life_change;
+        events[rec.player_id].pop_back();
+      }
+      record_count++;
+    }
+  }
+
+  bool found_game = false;
+  for (int player = 0; player < LIFE_MODEL_PLAYERS; ++player)
+    found_game = found_game || !events[player].empty();
+  // Nothing to resume: leave the groupers to the splash path. Otherwise a player
+  // the journal has nothing on starts fresh rather than keeping stale history.
+  if (found_game)
+  {
+    int max_life = player_store.getInt(KEY_LIFE_MAX, DEFAULT_LIFE_MAX);
+    for (int player = 0; player < LIFE_MODEL_PLAYERS; ++player)
+    {
+      if (seen[player])
+        groupers[player]->restoreHistory(totals[player], events[player]);
+      else
+        groupers[player]->resetHistory(max_life);
+    }
+    // The menu stores the mode on every switch, so it matches the journaled game
+    life_counter_mode = (PlayerMode)player_store.getInt(KEY_PLAYER_MODE, PLAYER_MODE_ONE_PLAYER);
+  }
+  LOG_I(STATE, "[journal_replay] %u pages, %u records in %u us%s\n", (unsigned)pages.size(), (unsigned)record_count,
+         (unsigned)(micros() - start_us), found_game ? ", game restored" : "");
+  return found_game;
+}
+
+#if JOURNAL_BENCH
+// Writes records in full pages at head_page, on the calling task
+static void write_records(const std::vector<JournalRecord> &records)
+{
+  for (size_t i = 0; i < records.size(); i += JOURNAL_RECORDS_PER_PAGE)
+    write_page(&records[i], std::min(records.size() - i, (size_t)JOURNAL_RECORDS_PER_PAGE));
+}
+
+// The records a 1P game of `minutes` leaves in the journal: taps closer than
+// GROUPER_WINDOW merge into one event, as the grouper does
+static void bench_records(uint32_t minutes, std::vector<JournalRecord> &records)
+{
+  std::vector<ReplayStep> steps = replay_generate_game(minutes, 1, PLAYER_MODE_ONE_PLAYER);
+  std::vector<int16_t> changes;
+  int life = DEFAULT_LIFE_MAX;
+  int pending = 0;
+  uint32_t first_ms = 0, last_ms = 0;
+  auto commit = [&]()
+  {
+    if (!pending)
+      return;
+    life += pending;
+    changes.push_back(pending);
+    records.push_back({JOURNAL_EVENT, PLAYER_SINGLE, (int16_t)pending, (int16_t)life, 0xFFFF, last_ms, (int32_t)(first_ms / 1000)});
+    pending = 0;
+  };
+
+  records.clear();
+  records.push_back({JOURNAL_RESET, PLAYER_SINGLE, 0, DEFAULT_LIFE_MAX, 0xFFFF, 0, 0});
+  for (const ReplayStep &step : steps)
+  {
+    if (pending && step.at_ms - last_ms >= GROUPER_WINDOW)
+      commit();
+    if (step.op == REPLAY_LIFE)
+    {
+      if (!pending)
+        first_ms = step.at_ms;
+      pending += step.value;
+      last_ms = step.at_ms;
+    }
+    else if (step.op == REPLAY_UNDO)
+    {
+      if (pending)
+        pending = 0;
+      else if (!changes.empty())
+      {
+        life -= changes.back();
+        changes.pop_back();
+        records.push_back({JOURNAL_UNDO, PLAYER_SINGLE, 0, 0, 0xFFFF, 0, 0});
+      }
+    }
+  }
+  commit();
+}
+
+// Erases the pages a run used and starts the ring over
+static void erase_pages(uint32_t pages)
+{
+  size_t bytes = ((pages * JOURNAL_PAGE_SIZE + JOURNAL_SECTOR_SIZE - 1) / JOURNAL_SECTOR_SIZE) * JOURNAL_SECTOR_SIZE;
+  esp_partition_erase_range(journal_partition, 0, std::min(bytes, (size_t)journal_partition->size));
+  head_page = 0;
+  next_seq = 1;
+  erased_sector = -1;
+}
+
+// Puts the game on screen back into the journal after the runs replaced it
+static void rewrite_game(void)
+{
+  EventGrouper *groupers[LIFE_MODEL_PLAYERS] = {&event_grouper, &event_grouper_p1, &event_grouper_p2};
+  std::vector<JournalRecord> records;
+  for (int player = 0; player < LIFE_MODEL_PLAYERS; ++player)
+  {
+    size_t reset_at = records.size();
+    int base_life = groupers[player]->getLifeTotal();
+    records.push_back({JOURNAL_RESET, (uint8_t)player, 0, 0, 0xFFFF, 0, 0});
+    HistoryCursor cursor = groupers[player]->getHistoryLog().cursor();
+    LifeHistoryEvent evt;
+    while (cursor.next(evt))
+    {
+      base_life -= evt.net_life_change;
+      records.push_back({JOURNAL_EVENT, (uint8_t)player, (int16_t)evt.net_life_change, (int16_t)evt.life_total, 0xFFFF, evt.timestamp, evt.change_timestamp});
+    }
+    records[reset_at].life_total = base_life;
+  }
+  write_records(records);
+}
+
+void journal_benchmark(void)
+{
+  if (!journal_partition)
+    return;
+  static const uint32_t minutes[] = {30, 180, 600, 1800};
+
+  game_stash_save();
+  journal_pause(true);
+  while (uxQueueMessagesWaiting(journal_queue))
+    vTaskDelay(pdMS_TO_TICKS(10));
+  vTaskDelay(pdMS_TO_TICKS(JOURNAL_FLUSH_MS + 100)); // let the writer flush its partial page
+
+  erase_pages(page_count);
+  uint32_t used_pages = 0;
+  std::vector<JournalRecord> records;
+  for (uint32_t game_minutes : minutes)
+  {
+    bench_records(game_minutes, records);
+    head_page = 0;
+    next_seq = 1;
+    erased_sector = -1;
+    inline_erases = 0;
+    inline_erase_max_us = 0;
+    write_records(records);
+    used_pages = std::max(used_pages, head_page);
+
+    uint32_t start_us = micros();
+    scan_pages();
+    uint32_t scan_us = micros() - start_us;
+    size_t pages = valid_pages.size();
+    start_us = micros();
+    journal_replay();
+    uint32_t replay_us = micros() - start_us;
+    printf("[journal_benchmark] %u min: %u pages, %u records, scan %u us, replay %u us\n", (unsigned)game_minutes,
+           (unsigned)pages, (unsigned)records.size(), (unsigned)scan_us, (unsigned)replay_us);
+    // Written back to back, every sector was erased inline: the worst of these
+    // is the stall a write would cost the UI without the erase ahead
+    printf("[journal_benchmark] %u inline sector erases, up to %u us each\n", (unsigned)inline_erases, (unsigned)inline_erase_max_us);
+  }
+
+  game_stash_restore();
+  erase_pages(used_pages);
+  rewrite_game();
+  journal_pause(false);
+}
+#endif
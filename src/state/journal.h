@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include "helpers/event_grouper.h"
+
+// Append-only game journal in the "journal" flash partition. Committed life
+// changes and resets are queued without blocking and written by a background
+// task in CRC-protected pages; the partition is used as a ring so erases are
+// spread evenly. At boot the journal is replayed to rebuild the game after a
+// brown-out or any other unplanned reset.
+
+#define JOURNAL_PARTITION_LABEL "journal"
+#define JOURNAL_PAGE_SIZE 256
+#define JOURNAL_SECTOR_SIZE 4096
+#define JOURNAL_QUEUE_LEN 64
+#define JOURNAL_FLUSH_MS 500 // a partly filled page is written after this much quiet
+#define JOURNAL_MAGIC 0x4A524E4C // "JRNL"
+
+// Dev flag: times the boot scan and replay of synthetic long games, then puts
+// the current game back into the journal
+#ifndef JOURNAL_BENCH
+#define JOURNAL_BENCH 0
+#endif
+#define JOURNAL_BENCH_DELAY_MS 10000 // let the boot sweep finish first
+
+enum JournalRecordType : uint8_t
+{
+  JOURNAL_EVENT = 1,      // committed LifeHistoryEvent
+  JOURNAL_RESET = 2,      // player history cleared, life_total is the new base
+  JOURNAL_UNDO = 3,       // newest event of the player reverted
+  JOURNAL_SYNC = 4,       // queue only, never written: flush the partial page now
+  JOURNAL_ERASE_AHEAD = 5 // queue only, never written: erase the next sector now
+};
+
+struct JournalRecord
+{
+  uint8_t type;
+  uint8_t player_id;
+  int16_t net_life_change;
+  int16_t life_total;
+  uint16_t reserved;
+  uint32_t timestamp;
+  int32_t change_timestamp;
+};
+
+struct JournalPageHeader
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint16_t count;
+  uint16_t reserved;
+  uint32_t crc; // over the header up to here and the records
+};
+
+#define JOURNAL_RECORDS_PER_PAGE ((JOURNAL_PAGE_SIZE - sizeof(JournalPageHeader)) / sizeof(JournalRecord))
+
+// Finds the partition and the write position, starts the writer task
+void journal_init(void);
+// Non-blocking: both only queue a record for the writer task
+void journal_append(const LifeHistoryEvent &evt);
+void journal_reset(int player_id, int base_life);
+void journal_undo(int player_id);
+// Writes everything queued so far and waits for it, up to timeout_ms; for the
+// power-off path, where the board may lose power right after
+bool journal_sync(uint32_t timeout_ms);
+// Called while the UI is idle: has the writer erase the sector the next pages go
+// to, so writing them later does not stall the UI. Non-blocking.
+void journal_erase_ahead(void);
+// While paused records are dropped, e.g. during a replay run
+void journal_pause(bool paused);
+// Rebuilds the groupers from the journal and sets life_counter_mode; true if a
+// game with changes was found, otherwise nothing is touched
+bool journal_replay(void);
+#if JOURNAL_BENCH
+void journal_benchmark(void);
+#endif
@@ -0,0 +1,119 @@
+#include "life_model.h"
+#include <stdio.h>
+
+static LifeModel model = {};
+static lv_subject_t total_subjects[LIFE_MODEL_PLAYERS];
+static lv_subject_t pending_subjects[LIFE_MODEL_PLAYERS];
+static lv_subject_t amp_subject;
+static lv_timer_t *flush_timer = nullptr;
+
+static void flush_timer_cb(lv_timer_t *t)
+{
+  life_model_flush();
+}
+
+// Wake the flush timer so it runs on the next lv_timer_handler pass. It is created
+// after the display, so it sits ahead of the refresh timer and runs before rendering.
+static void schedule_flush()
+{
+  if (!flush_timer)
+    return;
+  lv_timer_resume(flush_timer);
+  lv_timer_ready(flush_timer);
+}
+
+void life_model_init()
+{
+  if (flush_timer)
+    return;
+  for (int player = 0; player < LIFE_MODEL_PLAYERS; ++player)
+  {
+    lv_subject_init_int(&total_subjects[player], model.players[player].life_total);
+    lv_subject_init_int(&pending_subjects[player], model.players[player].pending_change);
+    model.players[player].dirty = 0; // published by the init
+  }
+  lv_subject_init_int(&amp_subject, model.amp_value);
+  model.amp_dirty = false;
+  flush_timer = lv_timer_create(flush_timer_cb, LV_DEF_REFR_PERIOD, NULL);
+  lv_timer_pause(flush_timer);
+}
+
+lv_subject_t *life_model_subject_total(int player)
+{
+  return &total_subjects[player];
+}
+
+lv_subject_t *life_model_subject_pending(int player)
+{
+  return &pending_subjects[player];
+}
+
+lv_subject_t *life_model_subject_amp()
+{
+  return &amp_subject;
+}
+
+void life_model_set_total(int player, int life_total)
+{
+  if (player < 0 || player >= LIFE_MODEL_PLAYERS)
+    return;
+  LifeModelPlayer &state = model.players[player];
+  if (state.life_total == life_total)
+    return;
+  state.life_total = life_total;
+  state.dirty |= LIFE_DIRTY_TOTAL;
+  schedule_flush();
+}
+
+void life_model_set_pending(int player, int pending_change)
+{
+  if (player < 0 || player >= LIFE_MODEL_PLAYERS)
+    return;
+  LifeModelPlayer &state = model.players[player];
+  if (state.pending_change == pending_change)
+    return;
+  state.pending_change = pending_change;
+  state.dirty |= LIFE_DIRTY_PENDING;
+  schedule_flush();
+}
+
+void life_model_set_amp(int amp_value)
+{
+  if (model.amp_value == amp_value)
+    return;
+  model.amp_value = amp_value;
+  model.amp_dirty = true;
+  schedule_flush();
+}
+
+int life_model_get_amp()
+{
+  return model.amp_value;
+}
+
+const LifeModelPlayer &life_model_get(int player)
+{
+  return model.players[player];
+}
+
+void life_model_flush()
+{
+  if (!flush_timer)
+    return; // no subjects before init
+  for (int player = 0; player < LIFE_MODEL_PLAYERS; ++player)
+  {
+    LifeModelPlayer &state = model.players[player];
+    uint8_t dirty = state.dirty;
+    state.dirty = 0;
+    if (dirty & LIFE_DIRTY_TOTAL)
+      lv_subject_set_int(&total_subjects[player], state.life_total);
+    if (dirty & LIFE_DIRTY_PENDING)
+      lv_subject_set_int(&pending_subjects[player], state.pending_change);
+  }
+  if (model.amp_dirty)
+  {
+    model.amp_dirty = false;
+    lv_subject_set_int(&amp_subject, model.amp_value);
+  }
+  lv_timer_pause(flush_timer);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <lvgl.h>
+#include "constants/constants.h"
+
+// Plain game state for the life counters. Setters only record the new value and
+// mark it dirty; a single flush per frame publishes changed fields to their LVGL
+// observer subjects, so a burst of changes between two frames notifies each
+// observer once and fields that did not change notify nobody.
+//
+// Views subscribe with lv_subject_add_observer_obj() (or lv_label_bind_text())
+// on the subjects below; observers tied to an object go away with it and are
+// called once on subscription with the current value.
+
+#define LIFE_MODEL_PLAYERS 3 // PLAYER_SINGLE, PLAYER_ONE, PLAYER_TWO
+
+enum LifeModelDirty : uint8_t
+{
+  LIFE_DIRTY_TOTAL = 1 << 0,   // displayed life total (committed + pending)
+  LIFE_DIRTY_PENDING = 1 << 1  // grouped change shown above the total
+};
+
+struct LifeModelPlayer
+{
+  int life_total;
+  int pending_change;
+  uint8_t dirty;
+};
+
+struct LifeModel
+{
+  LifeModelPlayer players[LIFE_MODEL_PLAYERS];
+  int amp_value;
+  bool amp_dirty;
+};
+
+void life_model_init();
+
+// Int subjects: displayed life total and grouped change per player, amp count
+lv_subject_t *life_model_subject_total(int player);
+lv_subject_t *life_model_subject_pending(int player);
+lv_subject_t *life_model_subject_amp();
+
+void life_model_set_total(int player, int life_total);
+void life_model_set_pending(int player, int pending_change);
+void life_model_set_amp(int amp_value);
+int life_model_get_amp();
+const LifeModelPlayer &life_model_get(int player);
+
+// Publish dirty fields now (normally done by the per-frame timer)
+void life_model_flush();
@@ -0,0 +1,178 @@
+#include "theme.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include "constants/constants.h"
+#include "memory/mem_policy.h"
+#include "memory/slab.h"
+
+lv_style_t style_round_overlay;
+lv_style_t style_overlay_padded;
+lv_style_t style_back_button;
+lv_style_t style_back_label;
+lv_style_t style_button_label;
+lv_style_t style_value_label;
+lv_style_t style_menu_icon;
+lv_style_t style_table;
+lv_style_t style_bare_container;
+lv_style_t style_life_arc_main;
+lv_style_t style_life_arc_indicator;
+lv_style_t style_life_label;
+lv_style_t style_change_label;
+
+void theme_init(void)
+{
+  static bool initialized = false;
+  if (initialized)
+    return;
+
+  lv_style_init(&style_round_overlay);
+  lv_style_set_bg_color(&style_round_overlay, BLACK_COLOR);
+  lv_style_set_bg_opa(&style_round_overlay, LV_OPA_COVER);
+  lv_style_set_border_opa(&style_round_overlay, LV_OPA_TRANSP);
+  lv_style_set_outline_opa(&style_round_overlay, LV_OPA_TRANSP);
+  lv_style_set_radius(&style_round_overlay, LV_RADIUS_CIRCLE);
+
+  lv_style_init(&style_overlay_padded);
+  lv_style_set_pad_all(&style_overlay_padded, 16);
+
+  lv_style_init(&style_back_button);
+  lv_style_set_bg_color(&style_back_button, WHITE_COLOR);
+
+  lv_style_init(&style_back_label);
+  lv_style_set_text_font(&style_back_label, &lv_font_montserrat_20);
+  lv_style_set_text_color(&style_back_label, BLACK_COLOR);
+
+  lv_style_init(&style_button_label);
+  lv_style_set_text_font(&style_button_label, &lv_font_montserrat_20);
+
+  lv_style_init(&style_value_label);
+  lv_style_set_text_font(&style_value_label, &lv_font_montserrat_24);
+  lv_style_set_text_color(&style_value_label, WHITE_COLOR);
+
+  lv_style_init(&style_menu_icon);
+  lv_style_set_text_font(&style_menu_icon, &lv_font_montserrat_40);
+
+  lv_style_init(&style_table);
+  lv_style_set_radius(&style_table, LV_RADIUS_CIRCLE);
+  lv_style_set_border_opa(&style_table, LV_OPA_TRANSP);
+  lv_style_set_outline_opa(&style_table, LV_OPA_TRANSP);
+  lv_style_set_bg_color(&style_table, BLACK_COLOR);
+  lv_style_set_bg_opa(&style_table, LV_OPA_COVER);
+
+  lv_style_init(&style_bare_container);
+  lv_style_set_bg_opa(&style_bare_container, LV_OPA_TRANSP);
+  lv_style_set_border_opa(&style_bare_container, LV_OPA_TRANSP);
+  lv_style_set_border_width(&style_bare_container, 0);
+  lv_style_set_pad_all(&style_bare_container, 0);
+
+  lv_style_init(&style_life_arc_main);
+  lv_style_set_arc_opa(&style_life_arc_main, LV_OPA_TRANSP);
+  lv_style_set_arc_width(&style_life_arc_main, 0);
+
+  lv_style_init(&style_life_arc_indicator);
+  lv_style_set_arc_color(&style_life_arc_indicator, GREEN_COLOR);
+  lv_style_set_arc_width(&style_life_arc_indicator, ARC_WIDTH);
+
+  lv_style_init(&style_life_label);
+  lv_style_set_text_color(&style_life_label, WHITE_COLOR);
+
+  lv_style_init(&style_change_label);
+  lv_style_set_text_font(&style_change_label, &lv_font_montserrat_40);
+  lv_style_set_text_color(&style_change_label, WHITE_COLOR);
+
+  initialized = true;
+}
+
+// --- Benchmark ---
+
+// Heap blocks plus slab blocks: since the slab, small style arrays never reach
+// the heap counters
+static size_t lvgl_live_bytes()
+{
+  size_t live = slab_live_bytes();
+  for (int r = 0; r < MEM_REGION_COUNT; ++r)
+  {
+    MemRegionStats stats;
+    mem_policy_stats((MemRegion)r, stats);
+    live += stats.live;
+  }
+  return live;
+}
+
+// One overlay with a back button, the most repeated pattern in the menus
+static void build_widget(lv_obj_t *parent, bool shared)
+{
+  lv_obj_t *panel = lv_obj_create(parent);
+  lv_obj_t *btn = lv_btn_create(panel);
+  lv_obj_t *lbl = lv_label_create(btn);
+  if (shared)
+  {
+    lv_obj_add_style(panel, &style_round_overlay, LV_PART_MAIN);
+    lv_obj_add_style(panel, &style_overlay_padded, LV_PART_MAIN);
+    lv_obj_add_style(btn, &style_back_button, LV_PART_MAIN);
+    lv_obj_add_style(lbl, &style_back_label, 0);
+  }
+  else
+  {
+    lv_obj_set_style_bg_color(panel, BLACK_COLOR, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(panel, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(panel, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_outline_opa(panel, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_radius(panel, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(panel, 16, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(btn, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(lbl, &lv_font_montserrat_20, 0);
+    lv_obj_set_style_text_color(lbl, lv_color_black(), 0);
+  }
+}
+
+// What drawing asks for, for every object in the tree
+static uint32_t resolve_styles(lv_obj_t *obj)
+{
+  uint32_t sink = lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) + lv_obj_get_style_border_opa(obj, LV_PART_MAIN) +
+                  lv_obj_get_style_outline_opa(obj, LV_PART_MAIN) + lv_obj_get_style_radius(obj, LV_PART_MAIN) +
+                  lv_obj_get_style_pad_left(obj, LV_PART_MAIN) + lv_color_to_u16(lv_obj_get_style_bg_color(obj, LV_PART_MAIN)) +
+                  lv_color_to_u16(lv_obj_get_style_text_color(obj, 0)) + (uint32_t)(uintptr_t)lv_obj_get_style_text_font(obj, 0);
+  uint32_t count = lv_obj_get_child_count(obj);
+  for (uint32_t i = 0; i < count; ++i)
+    sink += resolve_styles(lv_obj_get_child(obj, i));
+  return sink;
+}
+
+void theme_benchmark(int objects)
+{
+  theme_init();
+  lv_obj_t *root = lv_obj_create(lv_layer_top());
+  lv_obj_add_flag(root, LV_OBJ_FLAG_HIDDEN); // measure styling, not drawing
+  const int resolve_passes = 20;
+  uint32_t build_us[2], resolve_us[2];
+  size_t bytes[2];
+  volatile uint32_t sink = 0;
+
+  for (int shared = 0; shared < 2; ++shared)
+  {
+    size_t live_before = lvgl_live_bytes();
+    uint32_t start_us = micros();
+    for (int i = 0; i < objects; ++i)
+      build_widget(root, shared);
+    build_us[shared] = micros() - start_us;
+    bytes[shared] = lvgl_live_bytes() - live_before;
+
+    start_us = micros();
+    for (int pass = 0; pass < resolve_passes; ++pass)
+      sink += resolve_styles(root);
+    resolve_us[shared] = micros() - start_us;
+    lv_obj_clean(root);
+  }
+  lv_obj_delete(root);
+  (void)sink;
+
+  for (int shared = 0; shared < 2; ++shared)
+    printf("[theme_benchmark] %s styles: %d widgets, %u B LVGL heap, build %u us, %d resolve passes %u us\n",
+           shared ? "shared" : "local ", objects, (unsigned)bytes[shared], (unsigned)build_us[shared],
+           resolve_passes, (unsigned)resolve_us[shared]);
+  printf("[theme_benchmark] shared saves %d B (%d B per widget), build %d%% faster, resolve %d%% faster\n",
+         (int)(bytes[0] - bytes[1]), objects ? (int)(bytes[0] - bytes[1]) / objects : 0,
+         build_us[0] ? (int)(100 - (int64_t)build_us[1] * 100 / build_us[0]) : 0,
+         resolve_us[0] ? (int)(100 - (int64_t)resolve_us[1] * 100 / resolve_us[0]) : 0);
+}
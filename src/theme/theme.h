@@ -0,0 +1,44 @@
+#pragma once
+#include <lvgl.h>
+
+// Shared styles, applied by reference with lv_obj_add_style(). A local
+// lv_obj_set_style_* call gives every object its own property array and a
+// style refresh per call; these are built once at boot and only cost each
+// object a pointer in its style list. Properties that change at runtime (arc
+// and text colors that follow the life total, fades) stay local.
+
+// Full-screen round menus and overlays: black disc, no border or outline
+extern lv_style_t style_round_overlay;
+// Extra inset for overlays laid out on a grid
+extern lv_style_t style_overlay_padded;
+// Menu back button and its label
+extern lv_style_t style_back_button;
+extern lv_style_t style_back_label;
+// Button captions and plain menu text
+extern lv_style_t style_button_label;
+// Settings names and values (white, larger)
+extern lv_style_t style_value_label;
+// Contextual menu quadrant icons
+extern lv_style_t style_menu_icon;
+// History table body
+extern lv_style_t style_table;
+// Invisible layout containers for the life counters
+extern lv_style_t style_bare_container;
+// Life arcs: no background track, fixed-width indicator
+extern lv_style_t style_life_arc_main;
+extern lv_style_t style_life_arc_indicator;
+// Life totals and grouped change labels
+extern lv_style_t style_life_label;
+extern lv_style_t style_change_label;
+
+// Called once after lv_init, before any screen is built
+void theme_init(void);
+
+// Dev builds: -DTHEME_BENCH_OBJECTS=200 builds that many styled widgets once
+// with local properties and once with the shared styles, and prints the LVGL
+// heap and time each takes
+#ifndef THEME_BENCH_OBJECTS
+#define THEME_BENCH_OBJECTS 0
+#endif
+#define THEME_BENCH_DELAY_MS 10000
+void theme_benchmark(int objects);
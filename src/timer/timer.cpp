@@ -2,58 +2,95 @@
 #include <stdio.h>
 #include "constants/constants.h"
 #include <state/state_store.h>
+#include <log/log.h>
 
 lv_obj_t *timer_container = nullptr; // Container for the timer label
 static lv_obj_t *timer_label = nullptr;
 static lv_timer_t *timer = nullptr;
 static int elapsed_seconds = 0;
 static bool timer_running = false;
+static uint32_t counted_tick = 0; // lv_tick up to which running time is counted
+static lv_subject_t seconds_subject;
+static lv_subject_t running_subject;
 
 // Forward declarations
 void reset_timer();
 
-// Format and update the timer label
-static void update_timer_label()
+static void timer_subjects_init()
 {
-  if (!timer_label)
+  static bool initialized = false;
+  if (initialized)
     return;
-  int minutes = elapsed_seconds / 60;
-  int seconds = elapsed_seconds % 60;
-  char buf[8];
-  snprintf(buf, sizeof(buf), "%02d:%02d", minutes, seconds);
-  lv_label_set_text(timer_label, buf);
-  if (timer_running)
-  {
-    lv_obj_set_style_text_color(timer_label, lv_color_white(), 0); // Change color to indicate running
-  }
-  else
+  lv_subject_init_int(&seconds_subject, elapsed_seconds);
+  lv_subject_init_int(&running_subject, timer_running);
+  initialized = true;
+}
+
+lv_subject_t *timer_subject_seconds()
+{
+  timer_subjects_init();
+  return &seconds_subject;
+}
+
+lv_subject_t *timer_subject_running()
+{
+  timer_subjects_init();
+  return &running_subject;
+}
+
+// Publish elapsed time and running state; observers only hear about changes
+static void publish_timer()
+{
+  timer_subjects_init();
+  if (lv_subject_get_int(&seconds_subject) != elapsed_seconds)
+    lv_subject_set_int(&seconds_subject, elapsed_seconds);
+  if (lv_subject_get_int(&running_subject) != (int)timer_running)
+    lv_subject_set_int(&running_subject, timer_running);
+}
+
+// Elapsed seconds subject -> mm:ss
+static void timer_text_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  int elapsed = lv_subject_get_int(subject);
+  lv_label_set_text_fmt(lv_observer_get_target_obj(observer), "%02d:%02d", elapsed / 60, elapsed % 60);
+}
+
+// Running subject -> white while running, gray while paused
+static void timer_color_observer_cb(lv_observer_t *observer, lv_subject_t *subject)
+{
+  lv_obj_set_style_text_color(lv_observer_get_target_obj(observer), lv_subject_get_int(subject) ? lv_color_white() : GRAY_COLOR, 0);
+}
+
+static void set_running(bool running)
+{
+  if (running && !timer_running)
   {
-    lv_obj_set_style_text_color(timer_label, GRAY_COLOR, 0); // Change color to indicate paused
+    counted_tick = lv_tick_get();
+    if (timer)
+      lv_timer_reset(timer); // tick in phase with the counted seconds
   }
+  timer_running = running;
+  publish_timer();
 }
 
-// Timer callback to increment time
+// Counts whole seconds of tick time rather than callbacks: the GUI task sleeps
+// through them while the always-on view is up and catches up on wake
 static void timer_tick_cb(lv_timer_t *t)
 {
-  if (timer_running)
-  {
-    elapsed_seconds++;
-    update_timer_label();
-  }
+  if (!timer_running)
+    return;
+  uint32_t seconds = lv_tick_elaps(counted_tick) / 1000;
+  if (!seconds)
+    return;
+  counted_tick += seconds * 1000;
+  elapsed_seconds += seconds;
+  publish_timer();
 }
 
 // Click event callback to start/pause timer (stopwatch style)
 static void timer_click_cb(lv_event_t *e)
 {
-  timer_running = !timer_running;
-  if (timer_running)
-  {
-    lv_obj_set_style_text_color(timer_label, lv_color_white(), 0); // Change color to indicate running
-  }
-  else
-  {
-    lv_obj_set_style_text_color(timer_label, GRAY_COLOR, 0); // Change color to indicate paused
-  }
+  set_running(!timer_running);
 }
 
 // Render the timer on screen
@@ -82,10 +119,10 @@ void render_timer(lv_obj_t *parent)
   {
     timer_label = lv_label_create(timer_container);
     lv_obj_set_style_text_font(timer_label, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(timer_label, GRAY_COLOR, 0);
     lv_obj_set_style_text_align(timer_label, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_align(timer_label, LV_ALIGN_BOTTOM_MID, 0, 8); // Align label nearly flush with bottom
-    update_timer_label();
+    lv_subject_add_observer_obj(timer_subject_seconds(), timer_text_observer_cb, timer_label, NULL);
+    lv_subject_add_observer_obj(timer_subject_running(), timer_color_observer_cb, timer_label, NULL);
   }
   // Create LVGL timer if not already created
   if (!timer)
@@ -94,12 +131,23 @@ void render_timer(lv_obj_t *parent)
   }
 }
 
+// Move the timer into another parent, keeping its elapsed time and running state
+void attach_timer(lv_obj_t *parent)
+{
+  if (!timer_container)
+  {
+    render_timer(parent);
+    return;
+  }
+  lv_obj_set_parent(timer_container, parent);
+}
+
 // Optionally, add a function to reset or stop the timer
 void reset_timer()
 {
   elapsed_seconds = 0;
   timer_running = false;
-  update_timer_label();
+  publish_timer();
 }
 
 // Fully teardown the timer and its state
@@ -118,20 +166,20 @@ void teardown_timer()
   timer_label = nullptr;
   elapsed_seconds = 0;
   timer_running = false;
+  publish_timer();
 }
 
 uint64_t toggle_show_timer()
 {
   uint64_t show_timer = player_store.getInt(KEY_SHOW_TIMER, 0);
   player_store.putInt(KEY_SHOW_TIMER, !show_timer);
-  printf("[toggle_show_timer] Timer visibility toggled to %s\n", !show_timer ? "off" : "on");
+  LOG_D(UI, "[toggle_show_timer] Timer visibility toggled to %s\n", !show_timer ? "off" : "on");
   return !show_timer;
 }
 
 bool toggle_timer_running()
 {
-  timer_running = !timer_running;
-  update_timer_label();
+  set_running(!timer_running);
   return timer_running;
 }
 
@@ -143,4 +191,12 @@ bool get_is_timer_running()
 int get_elapsed_seconds()
 {
   return elapsed_seconds;
+}
+
+// Put back a saved stopwatch (e.g. from the RTC snapshot)
+void restore_timer(int seconds, bool running)
+{
+  elapsed_seconds = seconds;
+  timer_running = false;
+  set_running(running);
 }
\ No newline at end of file
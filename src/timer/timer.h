@@ -7,6 +7,9 @@ extern lv_obj_t *timer_container;
 // Renders the timer label and sets up the timer logic
 void render_timer(lv_obj_t *parent);
 
+// Moves the timer to a new parent without resetting it (creates it if missing)
+void attach_timer(lv_obj_t *parent);
+
 // Resets and stops the timer
 void reset_timer();
 
@@ -23,4 +26,11 @@ int get_elapsed_seconds();
 bool get_is_timer_running();
 
 // Toggles the running state of the timer (start/pause)
-bool toggle_timer_running();
\ No newline at end of file
+bool toggle_timer_running();
+
+// Restores elapsed time and running state saved before deep sleep
+void restore_timer(int seconds, bool running);
+
+// Int subjects for any view of the stopwatch: elapsed seconds, running (0/1)
+lv_subject_t *timer_subject_seconds();
+lv_subject_t *timer_subject_running();
\ No newline at end of file
@@ -2,18 +2,29 @@
 #include "gui_main.h"
 #include "gestures/gestures.h"
 #include "esp_display_panel.hpp"
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#include "power_key/power_pm.h"
+#include "helpers/refresh_rate.h"
+#include "touch/touch_capture.h"
 
 extern esp_panel::board::Board *board;
 
 static void touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
 {
+#if TOUCH_CAPTURE
+  if (touch_replay_read(data))
+    return;
+#endif
   if (!board->getTouch())
   {
     data->state = LV_INDEV_STATE_REL;
     return;
   }
   std::vector<esp_panel::drivers::TouchPoint> points;
+  pm_lock(PM_LOCK_TOUCH);
   board->getTouch()->readRawData(1, 0, 1); // Reduced timeout from 10ms to 1ms
+  pm_unlock(PM_LOCK_TOUCH);
   bool isSuccess = board->getTouch()->getPoints(points);
   if (isSuccess && points.size() > 0)
   {
@@ -26,6 +37,21 @@ static void touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
   {
     data->state = LV_INDEV_STATE_REL;
   }
+#if TOUCH_CAPTURE
+  touch_capture_record(data);
+#endif
+}
+
+// Touch INT fired: wakes the GUI task when polling is paused (runs in ISR context)
+static bool IRAM_ATTR touch_interrupt_cb(void *user_data)
+{
+  // Level triggered so touch can also wake light sleep (edges cannot): flip to
+  // the opposite level so each pulse fires once on each edge, like the power key
+  // (and like there, only inline gpio_ll calls so it is safe with the cache off)
+  bool active = gpio_ll_get_level(&GPIO, ESP_PANEL_BOARD_TOUCH_INT_IO) == ESP_PANEL_BOARD_TOUCH_INT_LEVEL;
+  int next_level = active ? !ESP_PANEL_BOARD_TOUCH_INT_LEVEL : ESP_PANEL_BOARD_TOUCH_INT_LEVEL;
+  gpio_ll_set_intr_type(&GPIO, ESP_PANEL_BOARD_TOUCH_INT_IO, next_level ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  return refresh_rate_touch_from_isr();
 }
 
 lv_indev_t* init_touch()
@@ -33,5 +59,12 @@ lv_indev_t* init_touch()
   lv_indev_t *indev = lv_indev_create();
   lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(indev, touch_read_cb);
+  if (board->getTouch())
+  {
+    board->getTouch()->attachInterruptCallback(touch_interrupt_cb);
+    // After the driver set the pin up as an edge interrupt
+    gpio_wakeup_enable((gpio_num_t)ESP_PANEL_BOARD_TOUCH_INT_IO,
+                       ESP_PANEL_BOARD_TOUCH_INT_LEVEL ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  }
   return indev;
 }
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "touch_capture.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <stdio.h>
+#include "gestures/gestures.h"
+#include "helpers/refresh_rate.h"
+#include "constants/constants.h"
+#include "state/journal.h"
+#include "replay/game_stash.h"
+#include "menu/menu.h"
+
+#if TOUCH_CAPTURE
+
+enum TouchCaptureMode
+{
+  CAPTURE_OFF,
+  CAPTURE_RECORDING,
+  CAPTURE_REPLAYING
+};
+
+static TouchCaptureMode mode = CAPTURE_OFF;
+
+// Capture rings; count keeps growing, the oldest entries are overwritten
+static TouchSample *samples = nullptr;
+static uint32_t sample_count = 0;
+static bool last_pressed = false;
+static GestureMark expected[TOUCH_CAPTURE_GESTURES];
+static uint32_t expected_count = 0;
+
+// Replay state, in capture time
+static GestureMark observed[TOUCH_CAPTURE_GESTURES];
+static uint32_t observed_count = 0;
+static uint32_t replay_speed = 1;
+static uint32_t replay_start_tick = 0;
+static uint32_t replay_origin_ms = 0;
+static uint32_t replay_index = 0;
+static uint32_t replay_now_ms = 0;
+
+static uint32_t ring_first(uint32_t count, uint32_t size)
+{
+  return count > size ? count - size : 0;
+}
+
+static const TouchSample &sample_at(uint32_t i)
+{
+  return samples[i % TOUCH_CAPTURE_SAMPLES];
+}
+
+void touch_capture_start(void)
+{
+  if (!samples)
+  {
+    // Large and only touched at the touch polling rate, so PSRAM is fine
+    samples = (TouchSample *)heap_caps_malloc(TOUCH_CAPTURE_SAMPLES * sizeof(TouchSample), MALLOC_CAP_SPIRAM);
+    if (!samples)
+      samples = (TouchSample *)malloc(TOUCH_CAPTURE_SAMPLES * sizeof(TouchSample));
+    if (!samples)
+    {
+      printf("[touch_capture_start] Out of memory\n");
+      return;
+    }
+  }
+  sample_count = 0;
+  expected_count = 0;
+  last_pressed = false;
+  mode = CAPTURE_RECORDING;
+  printf("[touch_capture_start] Recording\n");
+}
+
+void touch_capture_stop(void)
+{
+  if (mode == CAPTURE_RECORDING)
+    mode = CAPTURE_OFF;
+  printf("[touch_capture_stop] %u samples, %u gestures\n", (unsigned)sample_count, (unsigned)expected_count);
+}
+
+void touch_capture_record(const lv_indev_data_t *data)
+{
+  if (mode != CAPTURE_RECORDING)
+    return;
+  bool pressed = data->state == LV_INDEV_STATE_PRESSED;
+  // Released reads only matter as the edge that ends a touch
+  if (!pressed && !last_pressed)
+    return;
+  last_pressed = pressed;
+  samples[sample_count % TOUCH_CAPTURE_SAMPLES] = {lv_tick_get(), (int16_t)data->point.x, (int16_t)data->point.y, pressed};
+  sample_count++;
+}
+
+void touch_capture_note_gesture(uint8_t gesture)
+{
+  if (mode == CAPTURE_RECORDING)
+    expected[expected_count++ % TOUCH_CAPTURE_GESTURES] = {lv_tick_get(), gesture};
+  else if (mode == CAPTURE_REPLAYING && observed_count < TOUCH_CAPTURE_GESTURES)
+    observed[observed_count++] = {replay_now_ms, gesture};
+}
+
+// "T <ms> <x> <y> <pressed>" and "G <ms> <gesture>" lines, oldest first
+void touch_capture_dump(void)
+{
+  printf("[touch_capture_dump] begin\n");
+  for (uint32_t i = ring_first(sample_count, TOUCH_CAPTURE_SAMPLES); i < sample_count; ++i)
+  {
+    const TouchSample &s = sample_at(i);
+    printf("T %u %d %d %u\n", (unsigned)s.t_ms, s.x, s.y, s.pressed);
+  }
+  for (uint32_t i = ring_first(expected_count, TOUCH_CAPTURE_GESTURES); i < expected_count; ++i)
+  {
+    const GestureMark &g = expected[i % TOUCH_CAPTURE_GESTURES];
+    printf("G %u %s\n", (unsigned)g.t_ms, gesture_name((GestureType)g.gesture));
+  }
+  printf("[touch_capture_dump] end\n");
+}
+
+// Held taps cycling through the four quadrants, each firing the quadrant tap
+// followed by its half on release, like trigger_zone_gestures does
+void touch_capture_synthesize(uint32_t touches)
+{
+  static const int16_t points[4][3] = {
+      {90, 90, (int16_t)GestureType::TapTopLeft},
+      {270, 90, (int16_t)GestureType::TapTopRight},
+      {270, 270, (int16_t)GestureType::TapBottomRight},
+      {90, 270, (int16_t)GestureType::TapBottomLeft}};
+  touch_capture_start();
+  if (mode != CAPTURE_RECORDING)
+    return;
+  mode = CAPTURE_OFF;
+  uint32_t t = lv_tick_get();
+  for (uint32_t i = 0; i < touches; ++i)
+  {
+    const int16_t *p = points[i % 4];
+    for (int s = 0; s < TOUCH_SYNTH_HOLD_SAMPLES; ++s, t += REFRESH_ACTIVE_PERIOD_MS)
+      samples[sample_count++ % TOUCH_CAPTURE_SAMPLES] = {t, p[0], p[1], 1};
+    samples[sample_count++ % TOUCH_CAPTURE_SAMPLES] = {t, p[0], p[1], 0};
+    GestureType half = p[1] < SCREEN_DIAMETER / 2 ? GestureType::TapTop : GestureType::TapBottom;
+    expected[expected_count++ % TOUCH_CAPTURE_GESTURES] = {t, (uint8_t)p[2]};
+    expected[expected_count++ % TOUCH_CAPTURE_GESTURES] = {t, (uint8_t)half};
+    t += TOUCH_SYNTH_GAP_MS;
+  }
+  printf("[touch_capture_synthesize] %u touches, %u samples (%u retained), %u gestures\n", (unsigned)touches,
+         (unsigned)sample_count, (unsigned)(sample_count - ring_first(sample_count, TOUCH_CAPTURE_SAMPLES)),
+         (unsigned)expected_count);
+}
+
+void touch_replay_start(uint32_t speed)
+{
+  if (mode != CAPTURE_OFF || sample_count == 0)
+  {
+    printf("[touch_replay_start] Nothing to replay\n");
+    return;
+  }
+  replay_index = ring_first(sample_count, TOUCH_CAPTURE_SAMPLES);
+  replay_origin_ms = sample_at(replay_index).t_ms - TOUCH_REPLAY_LEAD_MS;
+  replay_now_ms = replay_origin_ms;
+  replay_speed = speed ? speed : 1;
+  replay_start_tick = lv_tick_get();
+  observed_count = 0;
+  // Replayed taps change the game: keep them out of the journal and put the
+  // game back afterwards
+  game_stash_save();
+  journal_pause(true);
+  refresh_rate_hold(true);
+  mode = CAPTURE_REPLAYING;
+  printf("[touch_replay_start] %u samples at %ux\n", (unsigned)(sample_count - replay_index), (unsigned)replay_speed);
+}
+
+// Index of the press that starts the touch containing `t_ms`, in capture order
+static int touch_of(uint32_t t_ms, const uint32_t *press_ms, int presses)
+{
+  int touch = -1;
+  for (int i = 0; i < presses && press_ms[i] <= t_ms; ++i)
+    touch = i;
+  return touch;
+}
+
+static void replay_report(void)
+{
+  // Touch starts: pressed samples that follow a release
+  static uint32_t press_ms[TOUCH_CAPTURE_SAMPLES / 2];
+  int presses = 0;
+  bool pressed = false;
+  for (uint32_t i = ring_first(sample_count, TOUCH_CAPTURE_SAMPLES); i < sample_count; ++i)
+  {
+    const TouchSample &s = sample_at(i);
+    if (s.pressed && !pressed && presses < (int)(sizeof(press_ms) / sizeof(press_ms[0])))
+      press_ms[presses++] = s.t_ms;
+    pressed = s.pressed;
+  }
+
+  // Per gesture type latency from touch-down, as captured and as replayed
+  uint32_t capture_sum[GESTURE_TYPE_COUNT] = {0};
+  uint32_t capture_n[GESTURE_TYPE_COUNT] = {0};
+  uint32_t replay_sum[GESTURE_TYPE_COUNT] = {0};
+  uint32_t replay_n[GESTURE_TYPE_COUNT] = {0};
+  uint32_t first_expected = ring_first(expected_count, TOUCH_CAPTURE_GESTURES);
+  int mismatches = 0;
+  uint32_t e = first_expected;
+  uint32_t o = 0;
+
+  // Only compare touches both rings still cover fully. When the sample ring
+  // wrapped, gestures older than the first retained press have no touch; when
+  // the gesture ring wrapped, the touch holding the oldest gesture may have
+  // lost earlier ones.
+  int first_touch = 0;
+  if (expected_count > TOUCH_CAPTURE_GESTURES && e < expected_count)
+    first_touch = touch_of(expected[e % TOUCH_CAPTURE_GESTURES].t_ms, press_ms, presses) + 1;
+  while (e < expected_count && touch_of(expected[e % TOUCH_CAPTURE_GESTURES].t_ms, press_ms, presses) < first_touch)
+    e++;
+  while (o < observed_count && touch_of(observed[o].t_ms, press_ms, presses) < first_touch)
+    o++;
+
+  for (int touch = first_touch; touch < presses; ++touch)
+  {
+    // Gestures of this touch on both sides, compared in order
+    bool match = true;
+    while (true)
+    {
+      bool has_e = e < expected_count && touch_of(expected[e % TOUCH_CAPTURE_GESTURES].t_ms, press_ms, presses) == touch;
+      bool has_o = o < observed_count && touch_of(observed[o].t_ms, press_ms, presses) == touch;
+      if (!has_e && !has_o)
+        break;
+      if (has_e)
+      {
+        const GestureMark &g = expected[e % TOUCH_CAPTURE_GESTURES];
+        capture_sum[g.gesture] += g.t_ms - press_ms[touch];
+        capture_n[g.gesture]++;
+      }
+      if (has_o)
+      {
+        replay_sum[observed[o].gesture] += observed[o].t_ms - press_ms[touch];
+        replay_n[observed[o].gesture]++;
+      }
+      if (has_e != has_o || (has_e && expected[e % TOUCH_CAPTURE_GESTURES].gesture != observed[o].gesture))
+        match = false;
+      if (has_e)
+        e++;
+      if (has_o)
+        o++;
+    }
+    if (!match)
+    {
+      mismatches++;
+      printf("[touch_replay] Touch %d at %u ms recognized differently\n", touch, (unsigned)press_ms[touch]);
+    }
+  }
+
+  printf("[touch_replay] %d touches, %d misclassified\n", presses - first_touch, mismatches);
+  for (int g = 0; g < GESTURE_TYPE_COUNT; ++g)
+  {
+    if (!capture_n[g] && !replay_n[g])
+      continue;
+    printf("[touch_replay] %-20s captured %3u avg %4u ms, replayed %3u avg %4u ms\n", gesture_name((GestureType)g),
+           (unsigned)capture_n[g], capture_n[g] ? (unsigned)(capture_sum[g] / capture_n[g]) : 0,
+           (unsigned)replay_n[g], replay_n[g] ? (unsigned)(replay_sum[g] / replay_n[g]) : 0);
+  }
+}
+
+// Deferred out of the indev read: restoring may switch the player mode
+static void replay_finish(void *user_data)
+{
+  replay_report();
+  renderMenu(MENU_NONE, false);
+  game_stash_restore();
+  journal_pause(false);
+}
+
+bool touch_replay_read(lv_indev_data_t *data)
+{
+  if (mode != CAPTURE_REPLAYING)
+    return false;
+  replay_now_ms = replay_origin_ms + (lv_tick_get() - replay_start_tick) * replay_speed;
+  while (replay_index + 1 < sample_count && sample_at(replay_index + 1).t_ms <= replay_now_ms)
+    replay_index++;
+
+  const TouchSample &s = sample_at(replay_index);
+  bool started = s.t_ms <= replay_now_ms;
+  data->point.x = s.x;
+  data->point.y = s.y;
+  data->state = (started && s.pressed) ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+
+  // Done once the last sample has played and late gestures had time to fire
+  if (replay_index + 1 == sample_count && started && !s.pressed && replay_now_ms - s.t_ms > TOUCH_REPLAY_TAIL_MS)
+  {
+    mode = CAPTURE_OFF;
+    refresh_rate_hold(false);
+    lv_async_call(replay_finish, NULL);
+  }
+  return true;
+}
+
+void touch_capture_poll_serial(void)
+{
+  while (Serial.available())
+  {
+    switch (Serial.read())
+    {
+    case 'c':
+      touch_capture_start();
+      break;
+    case 's':
+      touch_capture_stop();
+      break;
+    case 'd':
+      touch_capture_dump();
+      break;
+    case 'r':
+      touch_replay_start(1);
+      break;
+    case 'f':
+      touch_replay_start(TOUCH_REPLAY_FAST_SPEED);
+      break;
+    case 'l':
+      touch_capture_synthesize(TOUCH_SYNTH_TOUCHES);
+      break;
+    }
+  }
+}
+
+#endif // TOUCH_CAPTURE
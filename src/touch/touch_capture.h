@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include <lvgl.h>
+
+// Raw touch capture and replay, to reproduce a user's exact touch pattern and
+// measure gesture recognition. Compiled in with -DTOUCH_CAPTURE=1 and driven
+// over serial: 'c' starts a capture, 's' stops it, 'd' dumps it, 'r' replays
+// it at the original speed and 'f' at TOUCH_REPLAY_FAST_SPEED. 'l' loads a
+// synthetic capture longer than the sample ring, whose replay must come out
+// with no misclassified touches.
+//
+// A replay feeds the samples through the same touch_read_cb, so LVGL's press,
+// long-press and gesture logic sees them exactly like real input. The gestures
+// recognized while capturing are the expected result; the report compares them
+// per touch with the ones recognized during the replay. Long-press timing runs
+// on real time, so only 1x replays are meaningful for those.
+
+#ifndef TOUCH_CAPTURE
+#define TOUCH_CAPTURE 0
+#endif
+
+#define TOUCH_CAPTURE_SAMPLES 4096  // ring of pressed samples, ~65s of finger-down time
+#define TOUCH_CAPTURE_GESTURES 512  // ring of recognized gestures
+#define TOUCH_REPLAY_FAST_SPEED 4
+#define TOUCH_REPLAY_LEAD_MS 200    // released time fed before the first sample
+#define TOUCH_REPLAY_TAIL_MS 1500   // capture time after the last sample, for late gestures
+
+// Synthetic capture: 200 taps of 26 samples overflow the sample ring while all
+// of their gestures still fit in the gesture ring
+#define TOUCH_SYNTH_TOUCHES 200
+#define TOUCH_SYNTH_HOLD_SAMPLES 25 // pressed reads per tap, ~400 ms, short of a long press
+#define TOUCH_SYNTH_GAP_MS 400
+
+struct TouchSample
+{
+  uint32_t t_ms;
+  int16_t x;
+  int16_t y;
+  uint8_t pressed;
+};
+
+struct GestureMark
+{
+  uint32_t t_ms;
+  uint8_t gesture; // GestureType
+};
+
+void touch_capture_start(void);
+void touch_capture_stop(void);
+void touch_capture_dump(void);
+// Replaces the capture with `touches` synthetic taps and their expected gestures
+void touch_capture_synthesize(uint32_t touches);
+// Called by touch_read_cb with each real read
+void touch_capture_record(const lv_indev_data_t *data);
+// Called by trigger_gesture with each recognized gesture
+void touch_capture_note_gesture(uint8_t gesture);
+
+void touch_replay_start(uint32_t speed);
+// Fills data while a replay runs and returns true; false means read the panel
+bool touch_replay_read(lv_indev_data_t *data);
+
+// Handles pending serial commands, called from the GUI task
+void touch_capture_poll_serial(void);